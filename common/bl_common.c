@@ -215,6 +215,9 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 	uintptr_t image_base;
 	size_t image_size;
 	size_t bytes_read;
+#ifdef PLAT_LOAD_IMAGE_CHUNK_SIZE
+	size_t offset, chunk_size;
+#endif
 	int io_result;
 
 	assert(image_data != NULL);
@@ -261,11 +264,32 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
+#ifdef PLAT_LOAD_IMAGE_CHUNK_SIZE
+	/*
+	 * Read the image in chunks and let the platform process each one as
+	 * soon as it is in memory, e.g. to hash it while the rest is read.
+	 */
+	for (offset = 0; offset < image_size; offset += chunk_size) {
+		chunk_size = MIN(image_size - offset,
+				 (size_t)PLAT_LOAD_IMAGE_CHUNK_SIZE);
+		io_result = io_read(image_handle, image_base + offset,
+				    chunk_size, &bytes_read);
+		if ((io_result != 0) || (bytes_read < chunk_size)) {
+			WARN("Failed to load image id=%u (%i)\n", image_id,
+			     io_result);
+			goto exit;
+		}
+
+		plat_image_chunk_loaded(image_id, image_base,
+					offset + chunk_size, image_size);
+	}
+#else
 	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
+#endif
 
 	INFO("Image id=%u loaded: %p - %p\n", image_id, (void *) image_base,
 	     (void *) (image_base + image_size));
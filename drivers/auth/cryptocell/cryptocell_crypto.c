@@ -79,62 +79,39 @@ static void init(void)
 }
 
 /*
- * Verify a signature.
- *
- * Parameters are passed using the DER encoding format following the ASN.1
- * structures detailed above.
+ * Public keys parsed for the CryptoCell. The same key usually signs several
+ * certificates of the chain of trust. When the cache is full, the least
+ * recently used entry is replaced. The entries are never copied, as they are
+ * too big for the stack of the verification path.
  */
-static int verify_signature(void *data_ptr, unsigned int data_len,
-			    void *sig_ptr, unsigned int sig_len,
-			    void *sig_alg, unsigned int sig_alg_len,
-			    void *pk_ptr, unsigned int pk_len)
+#define PK_CACHE_ENTRIES	2
+#define PK_DER_MAX_LEN		(RSA_MOD_SIZE_IN_BYTES + 64)
+
+typedef struct pk_cache_entry {
+	unsigned int len;
+	unsigned int last_use;
+	uint8_t der[PK_DER_MAX_LEN];
+	CCSbNParams_t params;
+} pk_cache_entry_t;
+
+static pk_cache_entry_t pk_cache[PK_CACHE_ENTRIES];
+static unsigned int pk_cache_uses;
+
+/*
+ * Parse a SubjectPublicKeyInfo holding a RSA key into the modulus N and the
+ * Barrett n' value Np expected by the CryptoCell, in BE format.
+ */
+static int parse_public_key(void *pk_ptr, unsigned int pk_len,
+			    CCSbNParams_t *pk)
 {
-	CCError_t error;
-	CCSbNParams_t pk;
-	CCSbSignature_t signature;
-	int rc, exp;
-	mbedtls_asn1_buf sig_oid, alg_oid, params;
-	mbedtls_md_type_t md_alg;
+	mbedtls_asn1_buf alg_oid;
 	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_rsassa_pss_options pss_opts;
 	size_t len;
 	uint8_t *p, *end;
+	int rc, exp;
 	/* Temp buf to store the public key modulo (N) in LE format */
 	uint32_t RevN[SB_RSA_MOD_SIZE_IN_WORDS];
 
-	/* Verify the signature algorithm */
-	/* Get pointers to signature OID and parameters */
-	p = sig_alg;
-	end = p + sig_alg_len;
-	rc = mbedtls_asn1_get_alg(&p, end, &sig_oid, &params);
-	if (rc != 0)
-		return CRYPTO_ERR_SIGNATURE;
-
-	/* Get the actual signature algorithm (MD + PK) */
-	rc = mbedtls_oid_get_sig_alg(&sig_oid, &md_alg, &pk_alg);
-	if (rc != 0)
-		return CRYPTO_ERR_SIGNATURE;
-
-	/* The CryptoCell only supports RSASSA-PSS signature */
-	if (pk_alg != MBEDTLS_PK_RSASSA_PSS || md_alg != MBEDTLS_MD_NONE)
-		return CRYPTO_ERR_SIGNATURE;
-
-	/* Verify the RSASSA-PSS params */
-	/* The trailer field is verified to be 0xBC internally by this API */
-	rc = mbedtls_x509_get_rsassa_pss_params(&params, &md_alg,
-			&pss_opts.mgf1_hash_id,
-			&pss_opts.expected_salt_len);
-	if (rc != 0)
-		return CRYPTO_ERR_SIGNATURE;
-
-	/* The CryptoCell only supports SHA256 as hash algorithm */
-	if (md_alg != MBEDTLS_MD_SHA256 || pss_opts.mgf1_hash_id != MBEDTLS_MD_SHA256)
-		return CRYPTO_ERR_SIGNATURE;
-
-	if (pss_opts.expected_salt_len != RSA_SALT_LEN)
-		return CRYPTO_ERR_SIGNATURE;
-
-	/* Parse the public key */
 	p = pk_ptr;
 	end = p + pk_len;
 	rc = mbedtls_asn1_get_tag(&p, end, &len,
@@ -176,7 +153,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	 * The CCSbVerifySignature() API expects N and Np in BE format and
 	 * the signature in LE format. Copy N from certificate.
 	 */
-	memcpy(pk.N, p, RSA_MOD_SIZE_IN_BYTES);
+	memcpy(pk->N, p, RSA_MOD_SIZE_IN_BYTES);
 
 	/* Verify the RSA exponent */
 	p += len;
@@ -191,12 +168,117 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	 * Calculate the Np (Barrett n' value). The RSA_CalcNp() API expects
 	 * N in LE format. Hence reverse N into a temporary buffer `RevN`.
 	 */
-	UTIL_ReverseMemCopy((uint8_t *)RevN, (uint8_t *)pk.N, sizeof(RevN));
+	UTIL_ReverseMemCopy((uint8_t *)RevN, (uint8_t *)pk->N, sizeof(RevN));
 
-	RSA_CalcNp((uintptr_t)PLAT_CRYPTOCELL_BASE, RevN, pk.Np);
+	RSA_CalcNp((uintptr_t)PLAT_CRYPTOCELL_BASE, RevN, pk->Np);
 
 	/* Np is in LE format. Reverse it to BE */
-	UTIL_ReverseBuff((uint8_t *)pk.Np, sizeof(pk.Np));
+	UTIL_ReverseBuff((uint8_t *)pk->Np, sizeof(pk->Np));
+
+	return 0;
+}
+
+/*
+ * Get the CryptoCell parameters of a public key, from the cache if the key
+ * was used recently.
+ */
+static int get_public_key(void *pk_ptr, unsigned int pk_len,
+			  CCSbNParams_t *pk)
+{
+	pk_cache_entry_t *entry = NULL, *victim = &pk_cache[0];
+	int i, rc;
+
+	/* Keys too long for the cache are parsed every time */
+	if (pk_len > PK_DER_MAX_LEN)
+		return parse_public_key(pk_ptr, pk_len, pk);
+
+	for (i = 0; i < PK_CACHE_ENTRIES; i++) {
+		if ((pk_len != 0U) && (pk_cache[i].len == pk_len) &&
+		    (memcmp(pk_cache[i].der, pk_ptr, pk_len) == 0)) {
+			entry = &pk_cache[i];
+			break;
+		}
+		if (pk_cache[i].last_use < victim->last_use)
+			victim = &pk_cache[i];
+	}
+
+	if (entry == NULL) {
+		/* Parse the key straight into the entry it replaces */
+		victim->len = 0U;
+		victim->last_use = 0U;
+		rc = parse_public_key(pk_ptr, pk_len, &victim->params);
+		if (rc != 0)
+			return rc;
+
+		victim->len = pk_len;
+		memcpy(victim->der, pk_ptr, pk_len);
+		entry = victim;
+	}
+
+	entry->last_use = ++pk_cache_uses;
+	*pk = entry->params;
+
+	return 0;
+}
+
+/*
+ * Verify a signature.
+ *
+ * Parameters are passed using the DER encoding format following the ASN.1
+ * structures detailed above.
+ */
+static int verify_signature(void *data_ptr, unsigned int data_len,
+			    void *sig_ptr, unsigned int sig_len,
+			    void *sig_alg, unsigned int sig_alg_len,
+			    void *pk_ptr, unsigned int pk_len)
+{
+	CCError_t error;
+	CCSbNParams_t pk;
+	CCSbSignature_t signature;
+	int rc;
+	mbedtls_asn1_buf sig_oid, params;
+	mbedtls_md_type_t md_alg;
+	mbedtls_pk_type_t pk_alg;
+	mbedtls_pk_rsassa_pss_options pss_opts;
+	size_t len;
+	uint8_t *p, *end;
+
+	/* Verify the signature algorithm */
+	/* Get pointers to signature OID and parameters */
+	p = sig_alg;
+	end = p + sig_alg_len;
+	rc = mbedtls_asn1_get_alg(&p, end, &sig_oid, &params);
+	if (rc != 0)
+		return CRYPTO_ERR_SIGNATURE;
+
+	/* Get the actual signature algorithm (MD + PK) */
+	rc = mbedtls_oid_get_sig_alg(&sig_oid, &md_alg, &pk_alg);
+	if (rc != 0)
+		return CRYPTO_ERR_SIGNATURE;
+
+	/* The CryptoCell only supports RSASSA-PSS signature */
+	if (pk_alg != MBEDTLS_PK_RSASSA_PSS || md_alg != MBEDTLS_MD_NONE)
+		return CRYPTO_ERR_SIGNATURE;
+
+	/* Verify the RSASSA-PSS params */
+	/* The trailer field is verified to be 0xBC internally by this API */
+	rc = mbedtls_x509_get_rsassa_pss_params(&params, &md_alg,
+			&pss_opts.mgf1_hash_id,
+			&pss_opts.expected_salt_len);
+	if (rc != 0)
+		return CRYPTO_ERR_SIGNATURE;
+
+	/* The CryptoCell only supports SHA256 as hash algorithm */
+	if (md_alg != MBEDTLS_MD_SHA256 || pss_opts.mgf1_hash_id != MBEDTLS_MD_SHA256)
+		return CRYPTO_ERR_SIGNATURE;
+
+	if (pss_opts.expected_salt_len != RSA_SALT_LEN)
+		return CRYPTO_ERR_SIGNATURE;
+
+	/* Get the public key, parsed already if it was used before */
+	rc = get_public_key(pk_ptr, pk_len, &pk);
+	if (rc != 0)
+		return CRYPTO_ERR_SIGNATURE;
 
 	/* Get the signature (bitstring) */
 	p = sig_ptr;
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <console_buffered.h>
+#include <utils_def.h>
+
+/*
+ * Buffered console. Characters are queued to a ring and handed over to the
+ * transmit FIFO of the UART in bursts, whenever it has room, instead of
+ * waiting for the UART to be ready for each of them. The CPU only waits when
+ * the ring is full, or when the console is flushed.
+ */
+
+/* Framework entry points, see buffered_console.S */
+int console_buffered_putc(int c, console_t *console);
+int console_buffered_flush(console_t *console);
+
+int console_register(console_t *console);
+
+/* Hand over as much of the ring as the transmit FIFO takes */
+static void ring_drain(console_buffered_t *console)
+{
+	unsigned int offset, len, done;
+
+	while (console->tail != console->head) {
+		offset = console->tail & (console->size - 1U);
+		len = MIN(console->head - console->tail, console->size - offset);
+
+		done = console->ops->tx_burst(console->base,
+					      &console->buf[offset], len);
+		if (done == 0U)
+			break;
+
+		console->tail += done;
+	}
+}
+
+static void ring_put(console_buffered_t *console, uint8_t c)
+{
+	while ((console->head - console->tail) == console->size)
+		ring_drain(console);
+
+	console->buf[console->head & (console->size - 1U)] = c;
+	console->head++;
+}
+
+/* Called by console_buffered_putc() */
+int console_buffered_write(int c, console_buffered_t *console)
+{
+	/* Prepend '\r' to '\n' */
+	if (c == '\n')
+		ring_put(console, '\r');
+	ring_put(console, (uint8_t)c);
+
+	ring_drain(console);
+
+	return c;
+}
+
+/* Called by console_buffered_flush() */
+int console_buffered_drain(console_buffered_t *console)
+{
+	while (console->tail != console->head)
+		ring_drain(console);
+
+	if (console->ops->flush != NULL)
+		return console->ops->flush(console->base);
+
+	return 0;
+}
+
+int console_buffered_register(console_buffered_t *console, uintptr_t base,
+			      const console_buffered_ops_t *ops,
+			      uint8_t *buf, unsigned int size)
+{
+	assert(console != NULL);
+	assert((ops != NULL) && (ops->tx_burst != NULL));
+	assert(buf != NULL);
+	assert((size != 0U) && ((size & (size - 1U)) == 0U));
+
+	console->base = base;
+	console->ops = ops;
+	console->buf = buf;
+	console->size = size;
+	console->head = 0U;
+	console->tail = 0U;
+
+	console->console.putc = console_buffered_putc;
+	console->console.getc = NULL;
+	console->console.flush = console_buffered_flush;
+	console->console.flags = CONSOLE_FLAG_BOOT;
+
+	return console_register(&console->console);
+}
@@ -23,6 +23,15 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/*
+ * Number of files which can be open at the same time, across all the FIP
+ * devices. Each of them also takes an IO handle, and one more is needed while
+ * a file is being opened or read to access the backend.
+ */
+#ifndef MAX_FIP_FILES
+#define MAX_FIP_FILES		2
+#endif
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -31,24 +40,25 @@
 		x.node[0], x.node[1], x.node[2], x.node[3],			\
 		x.node[4], x.node[5]
 
-typedef struct {
-	unsigned int file_pos;
-	fip_toc_entry_t entry;
-} file_state_t;
-
-/* Maintain backend handles and file state per FIP device */
+/* Maintain backend handles per FIP device */
 typedef struct {
 	uintptr_t dev_spec;
 	uintptr_t backend_dev_handle;
 	uintptr_t backend_image_spec;
-	/* One file per device is maintained */
-	file_state_t current_file;
 } fip_dev_state_t;
 
+/* State of an open file, NULL dev marks a free entry */
+typedef struct {
+	fip_dev_state_t *dev;
+	unsigned int file_pos;
+	fip_toc_entry_t entry;
+} file_state_t;
+
 static const uuid_t uuid_null = {0};
 
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
+static file_state_t file_pool[MAX_FIP_FILES];
 
 /* Track number of allocated fip devices */
 static unsigned int fip_dev_count;
@@ -124,6 +134,22 @@ static int find_first_fip_state(const uintptr_t dev_spec,
 }
 
 
+/* Allocate a file state from the pool */
+static file_state_t *allocate_file_state(fip_dev_state_t *dev)
+{
+	unsigned int index;
+
+	for (index = 0; index < (unsigned int)MAX_FIP_FILES; ++index) {
+		if (file_pool[index].dev == NULL) {
+			file_pool[index].dev = dev;
+			return &file_pool[index];
+		}
+	}
+
+	return NULL;
+}
+
+
 /* Allocate a device info from the pool and return a pointer to it */
 static int allocate_dev_info(io_dev_info_t **dev_info)
 {
@@ -265,16 +291,11 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	assert((dev_info->info != (uintptr_t)NULL));
 
 	state = (fip_dev_state_t *)dev_info->info;
-	current_file = &state->current_file;
 
-	/* Can only have one file open per device at a time for the moment.
-	 * We need to track state like file cursor position. We know the header
-	 * lives at offset zero, so this entry should never be zero for an
-	 * active file. When the system supports dynamic memory allocation we
-	 * can allow more than one open file at a time if needed.
-	 */
-	if (current_file->entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
+	/* Each open file keeps its own state, like the file cursor position */
+	current_file = allocate_file_state(state);
+	if (current_file == NULL) {
+		WARN("fip_file_open : Too many open files.\n");
 		return -ENOMEM;
 	}
 
@@ -319,10 +340,9 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		 * base and size of the file.
 		 */
 		current_file->file_pos = 0;
-		entity->info = (uintptr_t)state;
+		entity->info = (uintptr_t)current_file;
 	} else {
 		/* Did not find the file in the FIP. */
-		current_file->entry.offset_address = 0;
 		result = -ENOENT;
 	}
 
@@ -330,6 +350,9 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	io_close(backend_handle);
 
  fip_file_open_exit:
+	if (result != 0)
+		zeromem(current_file, sizeof(file_state_t));
+
 	return result;
 }
 
@@ -340,7 +363,7 @@ static int fip_file_len(io_entity_t *entity, size_t *length)
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	*length =  ((fip_dev_state_t *)entity->info)->current_file.entry.size;
+	*length =  ((file_state_t *)entity->info)->entry.size;
 
 	return 0;
 }
@@ -362,8 +385,8 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
-	state = (fip_dev_state_t *)entity->info;
-	fp = &state->current_file;
+	fp = (file_state_t *)entity->info;
+	state = fp->dev;
 
 	/* Open the backend, attempt to access the blob image */
 	result = io_open(state->backend_dev_handle, state->backend_image_spec,
@@ -407,16 +430,14 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	fip_dev_state_t *state;
 	file_state_t *fp;
 
-	state = (fip_dev_state_t *)entity->info;
-	fp = &state->current_file;
+	fp = (file_state_t *)entity->info;
 
-	/* Clear our file state in the current file pointer.
+	/* Release our file state to the pool.
 	 * If we had malloc() we would free() here.
 	 */
-	if (fp->entry.offset_address != 0)
+	if (fp != NULL)
 		zeromem(fp, sizeof(file_state_t));
 
 	/* Clear the Entity info. */
@@ -11,6 +11,10 @@
 #include <string.h>
 #include <utils.h>
 
+#define CRC32_POLY			0xedb88320U
+
+static uint32_t crc32_table[256];
+
 static int unicode_to_ascii(unsigned short *str_in, unsigned char *str_out)
 {
 	uint8_t *name = (uint8_t *)str_in;
@@ -53,3 +57,36 @@ int parse_gpt_entry(gpt_entry_t *gpt_entry, partition_entry_t *entry)
 			PARTITION_BLOCK_SIZE;
 	return 0;
 }
+
+static void crc32_init(void)
+{
+	uint32_t crc;
+	int i, j;
+
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++) {
+			crc = (crc >> 1) ^ ((crc & 1U) ? CRC32_POLY : 0U);
+		}
+		crc32_table[i] = crc;
+	}
+}
+
+/*
+ * CRC32 as used by the GPT header and partition entry array. `crc` is the
+ * result of the previous call, or 0 for the first block of data.
+ */
+uint32_t gpt_crc32(uint32_t crc, const void *buf, size_t size)
+{
+	const uint8_t *p = buf;
+
+	if (crc32_table[1] == 0U) {
+		crc32_init();
+	}
+
+	crc = ~crc;
+	while (size-- > 0U) {
+		crc = crc32_table[(crc ^ *p++) & 0xffU] ^ (crc >> 8);
+	}
+	return ~crc;
+}
@@ -13,8 +13,18 @@
 #include <platform.h>
 #include <string.h>
 
+/* Open addressing hash table of partition names, at most half full */
+#define NAME_INDEX_SIZE		256
+
 static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
+static uint8_t gpt_block[PARTITION_BLOCK_SIZE];
+static gpt_entry_t gpt_entries[PLAT_PARTITION_MAX_ENTRIES];
 partition_entry_list_t list;
+/* Index + 1 in the list of the entries, 0 for an empty bucket */
+static uint8_t name_index[NAME_INDEX_SIZE];
+
+CASSERT(NAME_INDEX_SIZE >= (2 * PLAT_PARTITION_MAX_ENTRIES),
+	assert_name_index_size);
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
@@ -37,6 +47,39 @@ static void dump_entries(int num)
 #define dump_entries(num)	((void)num)
 #endif
 
+/* FNV-1a hash of a partition name */
+static unsigned int name_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+	return hash & (NAME_INDEX_SIZE - 1);
+}
+
+/* Index the entries by name. Like a linear search, the first match wins. */
+static void build_name_index(void)
+{
+	unsigned int i, idx;
+	int n;
+
+	memset(name_index, 0, sizeof(name_index));
+	for (n = 0; n < list.entry_count; n++) {
+		for (i = name_hash(list.list[n].name); name_index[i] != 0;
+		     i = (i + 1) & (NAME_INDEX_SIZE - 1)) {
+			idx = name_index[i] - 1;
+			if (strcmp(list.list[n].name, list.list[idx].name) == 0) {
+				break;
+			}
+		}
+		if (name_index[i] == 0) {
+			name_index[i] = n + 1;
+		}
+	}
+}
+
 /*
  * Load the first sector that carries MBR header.
  * The MBR boot signature should be always valid whether it's MBR or GPT.
@@ -72,71 +115,159 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 }
 
 /*
- * Load GPT header and check the GPT signature.
- * If partiton numbers could be found, check & update it.
+ * Load the GPT header at `lba`, check its signature and CRC, and that the
+ * partition entry array it describes is usable.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, uint64_t lba,
+			   gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
+	uint32_t crc;
 	int result;
 
-	result = io_seek(image_handle, IO_SEEK_SET, GPT_HEADER_OFFSET);
+	result = io_seek(image_handle, IO_SEEK_SET, lba * PARTITION_BLOCK_SIZE);
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
-			 sizeof(gpt_header_t), &bytes_read);
-	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
-		return result;
+	result = io_read(image_handle, (uintptr_t)&gpt_block,
+			 PARTITION_BLOCK_SIZE, &bytes_read);
+	if ((result != 0) || (bytes_read != PARTITION_BLOCK_SIZE)) {
+		return -EIO;
+	}
+	memcpy(header, gpt_block, sizeof(gpt_header_t));
+	if (memcmp(header->signature, GPT_SIGNATURE,
+		   sizeof(header->signature)) != 0) {
+		return -EINVAL;
+	}
+
+	/* The CRC covers the header with the CRC field cleared */
+	if ((header->size < GPT_HEADER_MIN_SIZE) ||
+	    (header->size > PARTITION_BLOCK_SIZE)) {
+		return -EINVAL;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-		   sizeof(header.signature)) != 0) {
+	((gpt_header_t *)gpt_block)->header_crc = 0;
+	crc = gpt_crc32(0, gpt_block, header->size);
+	if (crc != header->header_crc) {
+		WARN("GPT header at LBA %llu has a bad CRC\n",
+		     (unsigned long long)lba);
 		return -EINVAL;
 	}
 
-	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
-	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
-		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
+	if ((header->current_lba != lba) ||
+	    (header->part_size != sizeof(gpt_entry_t)) ||
+	    (header->list_num == 0)) {
+		return -EINVAL;
 	}
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Load the partition entry array described by `header` and check its CRC.
+ * The array is read in as few requests as the entry buffer allows, usually
+ * one, and up to PLAT_PARTITION_MAX_ENTRIES entries are parsed.
+ */
+static int load_gpt_entries(uintptr_t image_handle,
+			    const gpt_header_t *header)
 {
-	size_t bytes_read;
-	int result;
+	size_t bytes_read, size, left;
+	unsigned int i, count, parsed = 0;
+	uint32_t crc = 0;
+	int result, done = 0;
+
+	result = io_seek(image_handle, IO_SEEK_SET,
+			 header->part_lba * PARTITION_BLOCK_SIZE);
+	if (result != 0) {
+		return result;
+	}
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
+	left = (size_t)header->list_num * sizeof(gpt_entry_t);
+	while (left > 0) {
+		size = (left < sizeof(gpt_entries)) ? left : sizeof(gpt_entries);
+		result = io_read(image_handle, (uintptr_t)gpt_entries, size,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != size)) {
+			return -EIO;
+		}
+		crc = gpt_crc32(crc, gpt_entries, size);
+		left -= size;
+
+		/*
+		 * Only the leading valid entries are recorded, up to the
+		 * maximum number of entries.
+		 */
+		count = size / sizeof(gpt_entry_t);
+		for (i = 0; (i < count) && !done &&
+			    (parsed < PLAT_PARTITION_MAX_ENTRIES); i++) {
+			if (parse_gpt_entry(&gpt_entries[i],
+					    &list.list[parsed]) != 0) {
+				done = 1;
+				break;
+			}
+			parsed++;
+		}
+	}
+
+	if (crc != header->part_crc) {
+		WARN("GPT partition entries have a bad CRC\n");
 		return -EINVAL;
-	return result;
+	}
+	if (parsed == 0) {
+		return -EINVAL;
+	}
+
+	list.entry_count = parsed;
+	return 0;
+}
+
+static int load_gpt(uintptr_t image_handle, uint64_t lba,
+		    gpt_header_t *header)
+{
+	int result;
+
+	result = load_gpt_header(image_handle, lba, header);
+	if (result != 0) {
+		return result;
+	}
+	return load_gpt_entries(image_handle, header);
 }
 
+/*
+ * Load the primary GPT, or the backup one if the primary one is corrupted.
+ * The backup GPT is found from the primary header if it is valid, or else
+ * in the last block of the device.
+ */
 static int verify_partition_gpt(uintptr_t image_handle)
 {
-	gpt_entry_t entry;
-	int result, i;
+	gpt_header_t header;
+	uint64_t backup_lba = 0;
+	size_t size;
+	int result;
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
+	result = load_gpt_header(image_handle,
+				 GPT_HEADER_OFFSET / PARTITION_BLOCK_SIZE,
+				 &header);
+	if (result == 0) {
+		backup_lba = header.backup_lba;
+		result = load_gpt_entries(image_handle, &header);
+	}
+	if (result != 0) {
+		WARN("Primary GPT is invalid (%i), trying the backup one\n",
+		     result);
+		if ((backup_lba == 0) && (io_size(image_handle, &size) == 0) &&
+		    (size >= PARTITION_BLOCK_SIZE)) {
+			backup_lba = (size / PARTITION_BLOCK_SIZE) - 1;
+		}
+		if (backup_lba == 0) {
+			return -EINVAL;
+		}
+		result = load_gpt(image_handle, backup_lba, &header);
 		if (result != 0) {
-			break;
+			WARN("Backup GPT is invalid (%i)\n", result);
+			return result;
 		}
 	}
-	if (i == 0) {
-		return -EINVAL;
-	}
-	/*
-	 * Only records the valid partition number that is loaded from
-	 * partition table.
-	 */
-	list.entry_count = i;
+
+	build_name_index();
 	dump_entries(list.entry_count);
 
 	return 0;
@@ -167,10 +298,6 @@ int load_partition_table(unsigned int image_id)
 		return result;
 	}
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
-		assert(result == 0);
-		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
-		assert(result == 0);
 		result = verify_partition_gpt(image_handle);
 	} else {
 		/* MBR type isn't supported yet. */
@@ -184,11 +311,13 @@ exit:
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int i, idx;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	for (i = name_hash(name); name_index[i] != 0;
+	     i = (i + 1) & (NAME_INDEX_SIZE - 1)) {
+		idx = name_index[i] - 1;
+		if (strcmp(name, list.list[idx].name) == 0) {
+			return &list.list[idx];
 		}
 	}
 	return NULL;
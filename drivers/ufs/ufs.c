@@ -6,6 +6,7 @@
 
 #include <arch_helpers.h>
 #include <assert.h>
+#include <cassert.h>
 #include <debug.h>
 #include <delay_timer.h>
 #include <endian.h>
@@ -15,6 +16,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <ufs.h>
+#include <utils_def.h>
 
 #define CDB_ADDR_MASK			127
 #define ALIGN_CDB(x)			(((x) + CDB_ADDR_MASK) & ~CDB_ADDR_MASK)
@@ -25,6 +27,21 @@
 
 #define MAX_PRDT_SIZE			0x40000		/* 256KB */
 
+/*
+ * PRDT entries fitting in a descriptor after the UTRD header and the command
+ * and response UPIUs, and so the largest transfer a single command can do.
+ */
+#define MAX_PRDT_ENTRIES		((UFS_DESC_SIZE -			\
+					  ALIGN_CDB(sizeof(utrd_header_t)) -	\
+					  ALIGN_8(sizeof(cmd_upiu_t)) -		\
+					  ALIGN_8(sizeof(resp_upiu_t))) /	\
+					 sizeof(prdt_t))
+#define MAX_XFER_SIZE			(MAX_PRDT_ENTRIES * MAX_PRDT_SIZE)
+
+/* READ_10 and WRITE_10 transfer at most 65535 blocks */
+CASSERT(MAX_XFER_SIZE <= ((size_t)UINT16_MAX << UFS_BLOCK_SHIFT),
+	assert_ufs_max_xfer_size);
+
 static ufs_params_t ufs_params;
 static int nutrs;	/* Number of UTP Transfer Request Slots */
 
@@ -215,12 +232,6 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	unsigned int lba_cnt;
 	int prdt_size;
 
-
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->upiu >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	upiu = (cmd_upiu_t *)utrd->upiu;
 
@@ -279,6 +290,7 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	if (length) {
 		upiu->exp_data_trans_len = htobe32(length);
 		assert(lba_cnt <= UINT16_MAX);
+		assert(length <= MAX_XFER_SIZE);
 		prdt = (prdt_t *)utrd->prdt;
 
 		prdt_size = 0;
@@ -318,12 +330,6 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 	hd = (utrd_header_t *)utrd->header;
 	query_upiu = (query_upiu_t *)utrd->upiu;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
-
 	hd->i = 1;
 	hd->ct = CT_UFS_STORAGE;
 	hd->ocs = OCS_MASK;
@@ -370,11 +376,6 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	utrd_header_t *hd;
 	nop_out_upiu_t *nop_out;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	nop_out = (nop_out_upiu_t *)utrd->upiu;
 
@@ -388,12 +389,19 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
 }
 
-static void ufs_send_request(int task_tag)
+/*
+ * Ring the door bell of all the slots in the `slots` mask at once, with the
+ * transfer request list at `utrl_base`.
+ */
+static void ufs_ring_doorbell(uintptr_t utrl_base, unsigned int slots)
 {
 	unsigned int data;
-	int slot;
 
-	slot = task_tag - 1;
+	mmio_write_32(ufs_params.reg_base + UTRLBA,
+		      utrl_base & UINT32_MAX);
+	mmio_write_32(ufs_params.reg_base + UTRLBAU,
+		      (utrl_base >> 32) & UINT32_MAX);
+
 	/* clear all interrupts */
 	mmio_write_32(ufs_params.reg_base + IS, ~0);
 
@@ -406,7 +414,16 @@ static void ufs_send_request(int task_tag)
 	       UTRIACR_IATOVAL(0xFF);
 	mmio_write_32(ufs_params.reg_base + UTRIACR, data);
 	/* send request */
-	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, 1 << slot);
+	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, slots);
+}
+
+static void ufs_send_request(int task_tag)
+{
+	int slot;
+
+	slot = task_tag - 1;
+	ufs_ring_doorbell(ufs_params.desc_base + (slot * UFS_DESC_SIZE),
+			  1 << slot);
 }
 
 static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
@@ -632,52 +649,166 @@ void ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 	(void)result;
 }
 
-size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+/*
+ * Queued transfers
+ *
+ * Requests larger than MAX_XFER_SIZE are split into several commands, which
+ * are spread over the transfer request slots and sent with a single door
+ * bell write. For this the UTRDs have to be consecutive: the transfer
+ * request list is put at the start of the descriptor area, where the UTRD of
+ * slot 0 lives on the single request path, and slot N (N >= 1) keeps its UTP
+ * command descriptor in the descriptor N. Slot 0 is not used by the queue as
+ * its command descriptor overlaps the list.
+ */
+static void get_queued_utrd(int slot, utp_utrd_t *utrd)
 {
-	utp_utrd_t utrd;
+	utrd_header_t *hd;
+
+	assert((slot > 0) && (slot < nutrs));
+
+	memset((void *)utrd, 0, sizeof(utp_utrd_t));
+	utrd->header = ufs_params.desc_base + (slot * sizeof(utrd_header_t));
+	memset((void *)utrd->header, 0, sizeof(utrd_header_t));
+
+	utrd->task_tag = slot + 1;
+	utrd->upiu = ufs_params.desc_base + (slot * UFS_DESC_SIZE);
+	memset((void *)utrd->upiu, 0, UFS_DESC_SIZE);
+	utrd->resp_upiu = ALIGN_8(utrd->upiu + sizeof(cmd_upiu_t));
+	utrd->size_upiu = utrd->resp_upiu - utrd->upiu;
+	utrd->size_resp_upiu = ALIGN_8(sizeof(resp_upiu_t));
+	utrd->prdt = utrd->resp_upiu + utrd->size_resp_upiu;
+
+	hd = (utrd_header_t *)utrd->header;
+	hd->ucdba = utrd->upiu & UINT32_MAX;
+	hd->ucdbau = (utrd->upiu >> 32) & UINT32_MAX;
+	/* Both RUL and RUO is based on DWORD */
+	hd->rul = utrd->size_resp_upiu >> 2;
+	hd->ruo = utrd->size_upiu >> 2;
+}
+
+/* Wait for all the slots in the `slots` mask to complete */
+static int ufs_wait_slots(unsigned int slots)
+{
+	unsigned int data;
+
+	do {
+		data = mmio_read_32(ufs_params.reg_base + IS);
+		if ((data & (UFS_INT_UE | UFS_INT_UTPES | UFS_INT_DFES |
+			     UFS_INT_HCFES | UFS_INT_SBFES)) != 0)
+			return -EIO;
+		data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
+	} while ((data & slots) != 0);
+
+	return 0;
+}
+
+/* Return the number of bytes transferred by the completed command of `slot` */
+static size_t ufs_check_queued_resp(int slot, size_t length)
+{
+	utrd_header_t *hd;
 	resp_upiu_t *resp;
-	int result;
+	uintptr_t ucd;
 
-	assert((ufs_params.reg_base != 0) &&
-	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	hd = (utrd_header_t *)(ufs_params.desc_base +
+			       (slot * sizeof(utrd_header_t)));
+	ucd = ufs_params.desc_base + (slot * UFS_DESC_SIZE);
+	resp = (resp_upiu_t *)ALIGN_8(ucd + sizeof(cmd_upiu_t));
+	inv_dcache_range((uintptr_t)hd, sizeof(utrd_header_t));
+	inv_dcache_range(ucd, UFS_DESC_SIZE);
 
-	memset((void *)buf, 0, size);
-	get_utrd(&utrd);
-	ufs_prepare_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf, size);
-	ufs_send_request(utrd.task_tag);
-	result = ufs_check_resp(&utrd, RESPONSE_UPIU);
-	assert(result == 0);
-#ifdef UFS_RESP_DEBUG
-	dump_upiu(&utrd);
-#endif
-	resp = (resp_upiu_t *)utrd.resp_upiu;
+	assert(hd->ocs == OCS_SUCCESS);
+	assert((resp->trans_type & TRANS_TYPE_CODE_MASK) == RESPONSE_UPIU);
+	(void)hd;
+	return length - be32toh(resp->res_trans_cnt);
+}
+
+static size_t ufs_queue_xfer(uint8_t op, int lun, int lba, uintptr_t buf,
+			     size_t size)
+{
+	utp_utrd_t utrd;
+	size_t offset = 0, start, length, done = 0;
+	unsigned int slots;
+	int slot, result;
+
+	assert(nutrs > 1);
+
+	while (offset < size) {
+		/* Fill as many slots as needed, MAX_XFER_SIZE bytes each */
+		start = offset;
+		slots = 0;
+		for (slot = 1; (slot < nutrs) && (offset < size); slot++) {
+			length = MIN(size - offset, (size_t)MAX_XFER_SIZE);
+			get_queued_utrd(slot, &utrd);
+			ufs_prepare_cmd(&utrd, op, lun,
+					lba + (int)(offset >> UFS_BLOCK_SHIFT),
+					buf + offset, length);
+			flush_dcache_range(utrd.upiu, UFS_DESC_SIZE);
+			slots |= 1U << slot;
+			offset += length;
+		}
+
+		ufs_ring_doorbell(ufs_params.desc_base, slots);
+		result = ufs_wait_slots(slots);
+		assert(result == 0);
+
+		for (slot = 1; (slots >> slot) != 0U; slot++) {
+			length = MIN(offset - start, (size_t)MAX_XFER_SIZE);
+			done += ufs_check_queued_resp(slot, length);
+			start += length;
+		}
+	}
 	(void)result;
-	return size - resp->res_trans_cnt;
+	return done;
 }
 
-size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
+/* Send a transfer as one command per slot 0 request, for single slot hosts */
+static size_t ufs_single_xfer(uint8_t op, int lun, int lba, uintptr_t buf,
+			      size_t size)
 {
 	utp_utrd_t utrd;
 	resp_upiu_t *resp;
+	size_t offset, length, done = 0;
 	int result;
 
+	for (offset = 0; offset < size; offset += length) {
+		length = MIN(size - offset, (size_t)MAX_XFER_SIZE);
+		get_utrd(&utrd);
+		ufs_prepare_cmd(&utrd, op, lun,
+				lba + (int)(offset >> UFS_BLOCK_SHIFT),
+				buf + offset, length);
+		ufs_send_request(utrd.task_tag);
+		result = ufs_check_resp(&utrd, RESPONSE_UPIU);
+		assert(result == 0);
+#ifdef UFS_RESP_DEBUG
+		dump_upiu(&utrd);
+#endif
+		resp = (resp_upiu_t *)utrd.resp_upiu;
+		done += length - be32toh(resp->res_trans_cnt);
+	}
+	(void)result;
+	return done;
+}
+
+static size_t ufs_xfer_blocks(uint8_t op, int lun, int lba, uintptr_t buf,
+			      size_t size)
+{
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
 	       (ufs_params.desc_size >= UFS_DESC_SIZE));
 
-	memset((void *)buf, 0, size);
-	get_utrd(&utrd);
-	ufs_prepare_cmd(&utrd, CDBCMD_WRITE_10, lun, lba, buf, size);
-	ufs_send_request(utrd.task_tag);
-	result = ufs_check_resp(&utrd, RESPONSE_UPIU);
-	assert(result == 0);
-#ifdef UFS_RESP_DEBUG
-	dump_upiu(&utrd);
-#endif
-	resp = (resp_upiu_t *)utrd.resp_upiu;
-	(void)result;
-	return size - resp->res_trans_cnt;
+	if ((nutrs > 1) && (size > MAX_XFER_SIZE))
+		return ufs_queue_xfer(op, lun, lba, buf, size);
+	return ufs_single_xfer(op, lun, lba, buf, size);
+}
+
+size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+{
+	return ufs_xfer_blocks(CDBCMD_READ_10, lun, lba, buf, size);
+}
+
+size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
+{
+	return ufs_xfer_blocks(CDBCMD_WRITE_10, lun, lba, buf, size);
 }
 
 static void ufs_enum(void)
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __CONSOLE_BUFFERED_H__
+#define __CONSOLE_BUFFERED_H__
+
+#include <console.h>
+#include <stdint.h>
+
+/*
+ * Transmit operations of the UART behind a buffered console.
+ *
+ * tx_burst() writes as many of the `len` characters at `buf` as the transmit
+ * FIFO takes without waiting and returns how many it wrote.
+ *
+ * flush() optionally waits for the characters written to be sent out.
+ */
+typedef struct console_buffered_ops {
+	unsigned int (*tx_burst)(uintptr_t base, const uint8_t *buf,
+				 unsigned int len);
+	int (*flush)(uintptr_t base);
+} console_buffered_ops_t;
+
+typedef struct {
+	console_t console;
+	uintptr_t base;
+	const console_buffered_ops_t *ops;
+	uint8_t *buf;
+	unsigned int size;
+	unsigned int head;
+	unsigned int tail;
+} console_buffered_t;
+
+/*
+ * Register a console which writes to the UART at `base` through a ring of
+ * `size` bytes at `buf`, `size` being a power of 2. The UART must have been
+ * initialized, usually by registering its regular console.
+ *
+ * The buffered console is only used in the boot state, which is run by a
+ * single CPU, and its output is written out by console_flush(). The regular
+ * console of the UART should be kept for the runtime and crash states.
+ */
+int console_buffered_register(console_buffered_t *console, uintptr_t base,
+			      const console_buffered_ops_t *ops,
+			      uint8_t *buf, unsigned int size);
+
+/* Transmit operations of the drivers */
+unsigned int console_pl011_core_tx_burst(uintptr_t base, const uint8_t *buf,
+					 unsigned int len);
+int console_pl011_core_flush(uintptr_t base);
+unsigned int console_16550_core_tx_burst(uintptr_t base, const uint8_t *buf,
+					 unsigned int len);
+int console_16550_core_flush(uintptr_t base);
+
+#endif /* __CONSOLE_BUFFERED_H__ */
@@ -16,6 +16,7 @@
 #define GUID_LEN			16
 
 #define GPT_SIGNATURE			"EFI PART"
+#define GPT_HEADER_MIN_SIZE		92
 
 typedef struct gpt_entry {
 	unsigned char		type_uuid[GUID_LEN];
@@ -47,5 +48,6 @@ typedef struct gpt_header {
 } gpt_header_t;
 
 int parse_gpt_entry(gpt_entry_t *gpt_entry, partition_entry_t *entry);
+uint32_t gpt_crc32(uint32_t crc, const void *buf, size_t size);
 
 #endif	/* __GPT_H__ */
@@ -28,6 +28,13 @@
 #define PSCI_NUM_NON_CPU_PWR_DOMAINS	(PSCI_NUM_PWR_DOMAINS - \
 					 PLATFORM_CORE_COUNT)
 
+/*******************************************************************************
+ * Number of local power states per power level tracked by PSCI STAT
+ ******************************************************************************/
+#ifndef PLAT_MAX_PWR_LVL_STATES
+#define PLAT_MAX_PWR_LVL_STATES		2
+#endif
+
 /* This is the power level corresponding to a CPU */
 #define PSCI_CPU_PWR_LVL	(0)
 
@@ -272,6 +279,43 @@ typedef struct psci_cpu_data {
 	plat_local_state_t local_state;
 } psci_cpu_data_t;
 
+#if PSCI_STAT_HISTOGRAM
+/*******************************************************************************
+ * Layout of the PSCI statistics block kept when PSCI_STAT_HISTOGRAM is set. The
+ * platform may place it in memory readable by the normal world by defining
+ * PLAT_PSCI_STAT_SHM_BASE. A node is only ever written by one CPU at a time,
+ * which makes `seq` odd for the duration of the update, so readers retry while
+ * `seq` is odd or has changed under them. All durations are in ticks of the
+ * system counter running at `cntfrq`. Bucket `n` of a histogram counts the
+ * durations in the range [2^n, 2^(n+1)) ticks, the last one being open ended.
+ ******************************************************************************/
+#define PSCI_STAT_HIST_VERSION		U(1)
+#define PSCI_STAT_HIST_BUCKETS		U(32)
+
+typedef struct psci_stat_hist {
+	uint64_t residency;
+	uint64_t count;
+	uint32_t residency_hist[PSCI_STAT_HIST_BUCKETS];
+	uint32_t wakeup_hist[PSCI_STAT_HIST_BUCKETS];
+} psci_stat_hist_t;
+
+typedef struct psci_stat_hist_node {
+	uint32_t seq;
+	uint32_t reserved;
+	psci_stat_hist_t state[PLAT_MAX_PWR_LVL_STATES];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_stat_hist_node_t;
+
+typedef struct psci_stat_shm {
+	uint32_t version;
+	uint32_t num_states;
+	uint32_t num_cpus;
+	uint32_t num_non_cpu_nodes;
+	uint64_t cntfrq;
+	psci_stat_hist_node_t cpu[PLATFORM_CORE_COUNT];
+	psci_stat_hist_node_t non_cpu[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+} psci_stat_shm_t;
+#endif /* PSCI_STAT_HISTOGRAM */
+
 /*******************************************************************************
  * Structure populated by platform specific code to export routines which
  * perform common low level power management functions
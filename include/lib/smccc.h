@@ -62,16 +62,16 @@
 #define OEN_TOS_END			U(63)
 #define OEN_LIMIT			U(64)
 
-#ifndef __ASSEMBLY__
-
-#include <cassert.h>
-#include <stdint.h>
-
 #define SMCCC_MAJOR_VERSION U(1)
 #define SMCCC_MINOR_VERSION U(1)
 
 #define MAKE_SMCCC_VERSION(_major, _minor) (((_major) << 16) | (_minor))
 
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <stdint.h>
+
 /* Various flags passed to SMC handlers */
 #define SMC_FROM_SECURE		(U(0) << 0)
 #define SMC_FROM_NON_SECURE	(U(1) << 0)
@@ -38,6 +38,13 @@ void clear_mem_regions(mem_region_t *tbl, size_t nregions);
 int mem_region_in_array_chk(mem_region_t *tbl, size_t nregions,
 			    uintptr_t addr, size_t nbytes);
 
+/*
+ * Same as mem_region_in_array_chk() with a binary search, for a table whose
+ * regions are sorted by base address and do not overlap.
+ */
+int mem_region_in_sorted_array_chk(const mem_region_t *tbl, size_t nregions,
+				   uintptr_t addr, size_t nbytes);
+
 /*
  * Fill a region of normal memory of size "length" in bytes with zero bytes.
  *
@@ -17,8 +17,11 @@
 /* Function ID for requesting state switch of lower EL */
 #define ARM_SIP_SVC_EXE_STATE_SWITCH	0x82000020
 
+/* Function ID for running a batch of MM_COMMUNICATE requests (ENABLE_SPM) */
+#define ARM_SIP_SVC_MM_COMMUNICATE_BATCH	0xC2000021
+
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		0x0
-#define ARM_SIP_SVC_VERSION_MINOR		0x2
+#define ARM_SIP_SVC_VERSION_MINOR		0x3
 
 #endif /* __ARM_SIP_SVC_H__ */
@@ -70,6 +70,11 @@
 						ARM_SP_IMAGE_NS_BUF_SIZE,	\
 						MT_RW_DATA | MT_NS | MT_USER,	\
 						PAGE_SIZE)
+/* EL3 reads the tables of MM_COMMUNICATE_BATCH requests from this buffer */
+#define ARM_SP_IMAGE_NS_BUF_EL3_MMAP	MAP_REGION_FLAT(			\
+						ARM_SP_IMAGE_NS_BUF_BASE,	\
+						ARM_SP_IMAGE_NS_BUF_SIZE,	\
+						MT_RW_DATA | MT_NS)
 
 /*
  * RW memory, which uses the remaining Trusted DRAM. Placed after the memory
@@ -105,6 +105,8 @@ void plat_panic_handler(void) __dead2;
 const char *plat_log_get_prefix(unsigned int log_level);
 void bl2_plat_preload_setup(void);
 int plat_try_next_boot_source(void);
+void plat_image_chunk_loaded(unsigned int image_id, uintptr_t image_base,
+			     size_t loaded, size_t image_size);
 
 /*******************************************************************************
  * Mandatory BL1 functions
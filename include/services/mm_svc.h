@@ -28,4 +28,31 @@
 #define MM_COMMUNICATE_AARCH64		U(0xC4000041)
 #define MM_COMMUNICATE_AARCH32		U(0x84000041)
 
+/*
+ * MM_COMMUNICATE_BATCH is not part of [1]. It is an implementation defined
+ * variant of MM_COMMUNICATE, which runs several requests in a row in the
+ * partition before returning to the Normal world. It is provided by the Arm
+ * SiP service as ARM_SIP_SVC_MM_COMMUNICATE_BATCH, and takes a table of
+ * mm_communicate_batch_entry_t, located in the Non-secure buffer shared with
+ * the partition, and the number of entries in the table.
+ */
+
+/* Maximum number of entries in a MM_COMMUNICATE_BATCH table */
+#define MM_COMMUNICATE_BATCH_MAX	U(64)
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct mm_communicate_batch_entry {
+	/* Arguments of the MM_COMMUNICATE request, set by the caller */
+	uint64_t comm_buffer_address;
+	uint64_t comm_size_address;
+	/* Value returned by the partition for the request */
+	int64_t ret;
+	uint64_t reserved;
+} mm_communicate_batch_entry_t;
+
+#endif /* __ASSEMBLY__ */
+
 #endif /* __MM_SVC_H__ */
@@ -65,6 +65,9 @@
 
 int32_t spm_setup(void);
 
+uint64_t spm_mm_communicate_batch(uint64_t mm_cookie, uint64_t table_address,
+				  uint64_t table_count, void *handle);
+
 uint64_t spm_smc_handler(uint32_t smc_fid,
 			 uint64_t x1,
 			 uint64_t x2,
@@ -41,6 +41,20 @@ const spd_pm_ops_t *psci_spd_pm;
 static plat_local_state_t
 	psci_req_local_pwr_states[PLAT_MAX_PWR_LVL][PLATFORM_CORE_COUNT];
 
+#if PSCI_STATE_VOTE_COUNTS
+/*
+ * Number of CPUs requesting each local power state for each non cpu power
+ * domain, and mask of the states requested by at least one CPU. The target
+ * state of a power domain is the shallowest state in the mask. They are
+ * updated along with psci_req_local_pwr_states, under the same locks.
+ */
+CASSERT(PLAT_MAX_OFF_STATE < 32, assert_psci_vote_state_mask_size);
+
+static unsigned int
+	psci_req_state_votes[PSCI_NUM_NON_CPU_PWR_DOMAINS][PLAT_MAX_OFF_STATE + 1];
+static uint32_t psci_req_state_mask[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+#endif
+
 
 /*******************************************************************************
  * Arrays that hold the platform's power domain tree information for state
@@ -193,15 +207,31 @@ static unsigned int get_power_on_target_pwrlvl(void)
  *****************************************************************************/
 static void psci_set_req_local_pwr_state(unsigned int pwrlvl,
 					 unsigned int cpu_idx,
+					 unsigned int parent_idx,
 					 plat_local_state_t req_pwr_state)
 {
+#if PSCI_STATE_VOTE_COUNTS
+	plat_local_state_t old_state;
+#endif
+
 	/*
 	 * This should never happen, we have this here to avoid
 	 * "array subscript is above array bounds" errors in GCC.
 	 */
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
+	assert(psci_non_cpu_pd_nodes[parent_idx].level == pwrlvl);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Warray-bounds"
+#if PSCI_STATE_VOTE_COUNTS
+	old_state = psci_req_local_pwr_states[pwrlvl - 1][cpu_idx];
+	assert(req_pwr_state <= PLAT_MAX_OFF_STATE);
+	assert(psci_req_state_votes[parent_idx][old_state] != 0);
+
+	if (--psci_req_state_votes[parent_idx][old_state] == 0)
+		psci_req_state_mask[parent_idx] &= ~(1U << old_state);
+	if (psci_req_state_votes[parent_idx][req_pwr_state]++ == 0)
+		psci_req_state_mask[parent_idx] |= 1U << req_pwr_state;
+#endif
 	psci_req_local_pwr_states[pwrlvl - 1][cpu_idx] = req_pwr_state;
 #pragma GCC diagnostic pop
 }
@@ -211,10 +241,37 @@ static void psci_set_req_local_pwr_state(unsigned int pwrlvl,
  *****************************************************************************/
 void psci_init_req_local_pwr_states(void)
 {
+#if PSCI_STATE_VOTE_COUNTS
+	unsigned int idx;
+#endif
+
 	/* Initialize the requested state of all non CPU power domains as OFF */
 	memset(&psci_req_local_pwr_states, PLAT_MAX_OFF_STATE,
 			sizeof(psci_req_local_pwr_states));
+
+#if PSCI_STATE_VOTE_COUNTS
+	memset(&psci_req_state_votes, 0, sizeof(psci_req_state_votes));
+	for (idx = 0; idx < PSCI_NUM_NON_CPU_PWR_DOMAINS; idx++) {
+		psci_req_state_votes[idx][PLAT_MAX_OFF_STATE] =
+					psci_non_cpu_pd_nodes[idx].ncpus;
+		psci_req_state_mask[idx] = 1U << PLAT_MAX_OFF_STATE;
+	}
+#endif
+}
+
+#if PSCI_STATE_VOTE_COUNTS
+/******************************************************************************
+ * Helper function to return the shallowest local power state requested by the
+ * cpus of a non cpu power domain, which is the target state chosen by the
+ * default plat_get_target_pwr_state().
+ *****************************************************************************/
+static plat_local_state_t psci_get_voted_pwr_state(unsigned int parent_idx)
+{
+	assert(psci_req_state_mask[parent_idx] != 0);
+
+	return (plat_local_state_t)__builtin_ctz(psci_req_state_mask[parent_idx]);
 }
+#endif
 
 /******************************************************************************
  * Helper function to return a reference to an array containing the local power
@@ -363,6 +420,7 @@ void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 				PSCI_LOCAL_STATE_RUN);
 		psci_set_req_local_pwr_state(lvl,
 					     cpu_idx,
+					     parent_idx,
 					     PSCI_LOCAL_STATE_RUN);
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -398,8 +456,11 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info)
 {
 	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+#if !PSCI_STATE_VOTE_COUNTS || ENABLE_ASSERTIONS
 	unsigned int start_idx, ncpus;
-	plat_local_state_t target_state, *req_states;
+	plat_local_state_t *req_states;
+#endif
+	plat_local_state_t target_state;
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
@@ -409,9 +470,24 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
 
 		/* First update the requested power state */
-		psci_set_req_local_pwr_state(lvl, cpu_idx,
+		psci_set_req_local_pwr_state(lvl, cpu_idx, parent_idx,
 					     state_info->pwr_domain_state[lvl]);
 
+#if PSCI_STATE_VOTE_COUNTS
+		/*
+		 * The target local power state is the shallowest requested
+		 * one, which is kept track of as the requests are updated.
+		 */
+		target_state = psci_get_voted_pwr_state(parent_idx);
+#if ENABLE_ASSERTIONS
+		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+		req_states = psci_get_req_local_pwr_states(lvl, start_idx);
+		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		assert(target_state == plat_get_target_pwr_state(lvl,
+								  req_states,
+								  ncpus));
+#endif
+#else
 		/* Get the requested power states for this power level */
 		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
 		req_states = psci_get_req_local_pwr_states(lvl, start_idx);
@@ -424,6 +500,7 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 		target_state = plat_get_target_pwr_state(lvl,
 							 req_states,
 							 ncpus);
+#endif
 
 		state_info->pwr_domain_state[lvl] = target_state;
 
@@ -441,7 +518,8 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	 * set the target state as RUN.
 	 */
 	for (lvl = lvl + 1; lvl <= end_pwrlvl; lvl++) {
-		psci_set_req_local_pwr_state(lvl, cpu_idx,
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		psci_set_req_local_pwr_state(lvl, cpu_idx, parent_idx,
 					     state_info->pwr_domain_state[lvl]);
 		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
 
@@ -744,6 +822,10 @@ void psci_warmboot_entrypoint(void)
 	unsigned int end_pwrlvl, cpu_idx = plat_my_core_pos();
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 
+#if ENABLE_PSCI_STAT
+	psci_stats_wakeup();
+#endif
+
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
 	 * suspend.
@@ -770,7 +852,7 @@ void psci_warmboot_entrypoint(void)
 	psci_get_target_local_pwr_states(end_pwrlvl, &state_info);
 
 #if ENABLE_PSCI_STAT
-	plat_psci_stat_accounting_stop(&state_info);
+	psci_stats_accounting_stop(&state_info);
 #endif
 
 	/*
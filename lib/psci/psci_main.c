@@ -16,6 +16,73 @@
 #include <string.h>
 #include "psci_private.h"
 
+#if PSCI_STANDBY_STATE_CACHE
+/*
+ * Last CPU standby request of each CPU, which has been validated already.
+ * Platforms enabling the cache must validate power states independently of
+ * the runtime state.
+ */
+typedef struct psci_standby_state_cache {
+	unsigned int valid;
+	unsigned int power_state;
+	plat_local_state_t cpu_pd_state;
+} psci_standby_state_cache_t;
+
+static psci_standby_state_cache_t
+	psci_standby_state_cache[PLATFORM_CORE_COUNT];
+#endif
+
+/*******************************************************************************
+ * Enter the CPU standby state `cpu_pd_state` through the platform hook and
+ * return once the CPU has woken up.
+ ******************************************************************************/
+static void psci_cpu_standby(plat_local_state_t cpu_pd_state)
+{
+#if ENABLE_PSCI_STAT
+	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
+
+	state_info.pwr_domain_state[PSCI_CPU_PWR_LVL] = cpu_pd_state;
+#endif
+
+	/*
+	 * Set the state of the CPU power domain to the platform
+	 * specific retention state and enter the standby state.
+	 */
+	psci_set_cpu_local_state(cpu_pd_state);
+
+#if ENABLE_PSCI_STAT
+	psci_stats_accounting_start(&state_info);
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_HW_LOW_PWR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	psci_plat_pm_ops->cpu_standby(cpu_pd_state);
+
+#if ENABLE_PSCI_STAT
+	psci_stats_wakeup();
+#endif
+
+	/* Upon exit from standby, set the state back to RUN. */
+	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_HW_LOW_PWR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+#if ENABLE_PSCI_STAT
+	psci_stats_accounting_stop(&state_info);
+
+	/* Update PSCI stats */
+	psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info);
+#endif
+}
+
 /*******************************************************************************
  * PSCI frontend api for servicing SMCs. Described in the PSCI spec.
  ******************************************************************************/
@@ -57,7 +124,19 @@ int psci_cpu_suspend(unsigned int power_state,
 	unsigned int target_pwrlvl, is_power_down_state;
 	entry_point_info_t ep;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
-	plat_local_state_t cpu_pd_state;
+#if PSCI_STANDBY_STATE_CACHE
+	psci_standby_state_cache_t *cache =
+		&psci_standby_state_cache[plat_my_core_pos()];
+
+	/*
+	 * Go straight to the platform hook if this CPU has already requested
+	 * the same standby state.
+	 */
+	if ((cache->valid != 0U) && (cache->power_state == power_state)) {
+		psci_cpu_standby(cache->cpu_pd_state);
+		return PSCI_E_SUCCESS;
+	}
+#endif
 
 	/* Validate the power_state parameter */
 	rc = psci_validate_power_state(power_state, &state_info);
@@ -86,40 +165,14 @@ int psci_cpu_suspend(unsigned int power_state,
 		if  (!psci_plat_pm_ops->cpu_standby)
 			return PSCI_E_INVALID_PARAMS;
 
-		/*
-		 * Set the state of the CPU power domain to the platform
-		 * specific retention state and enter the standby state.
-		 */
-		cpu_pd_state = state_info.pwr_domain_state[PSCI_CPU_PWR_LVL];
-		psci_set_cpu_local_state(cpu_pd_state);
-
-#if ENABLE_PSCI_STAT
-		plat_psci_stat_accounting_start(&state_info);
-#endif
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_ENTER_HW_LOW_PWR,
-		    PMF_NO_CACHE_MAINT);
-#endif
-
-		psci_plat_pm_ops->cpu_standby(cpu_pd_state);
-
-		/* Upon exit from standby, set the state back to RUN. */
-		psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_EXIT_HW_LOW_PWR,
-		    PMF_NO_CACHE_MAINT);
+#if PSCI_STANDBY_STATE_CACHE
+		cache->power_state = power_state;
+		cache->cpu_pd_state =
+			state_info.pwr_domain_state[PSCI_CPU_PWR_LVL];
+		cache->valid = 1U;
 #endif
 
-#if ENABLE_PSCI_STAT
-		plat_psci_stat_accounting_stop(&state_info);
-
-		/* Update PSCI stats */
-		psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info);
-#endif
+		psci_cpu_standby(state_info.pwr_domain_state[PSCI_CPU_PWR_LVL]);
 
 		return PSCI_E_SUCCESS;
 	}
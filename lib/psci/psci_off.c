@@ -112,7 +112,7 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	psci_plat_pm_ops->pwr_domain_off(&state_info);
 
 #if ENABLE_PSCI_STAT
-	plat_psci_stat_accounting_start(&state_info);
+	psci_stats_accounting_start(&state_info);
 #endif
 
 exit:
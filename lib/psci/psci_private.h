@@ -272,6 +272,16 @@ u_register_t psci_stat_residency(u_register_t target_cpu,
 			unsigned int power_state);
 u_register_t psci_stat_count(u_register_t target_cpu,
 			unsigned int power_state);
+void psci_stats_accounting_start(const psci_power_state_t *state_info);
+void psci_stats_accounting_stop(const psci_power_state_t *state_info);
+#if PSCI_STAT_HISTOGRAM
+void psci_stats_init(void);
+void psci_stats_wakeup(void);
+#else
+static inline void psci_stats_wakeup(void)
+{
+}
+#endif
 
 /* Private exported functions from psci_mem_protect.c */
 int psci_mem_protect(unsigned int enable);
@@ -257,6 +257,10 @@ int psci_setup(const psci_lib_args_t *lib_args)
 	psci_caps |=  define_psci_cap(PSCI_STAT_COUNT_AARCH64);
 #endif
 
+#if PSCI_STAT_HISTOGRAM
+	psci_stats_init();
+#endif
+
 	return 0;
 }
 
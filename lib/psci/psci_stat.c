@@ -4,16 +4,15 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
+#include <cassert.h>
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <string.h>
 #include "psci_private.h"
 
-#ifndef PLAT_MAX_PWR_LVL_STATES
-#define PLAT_MAX_PWR_LVL_STATES 2
-#endif
-
 /* Following structure is used for PSCI STAT */
 typedef struct psci_stat {
 	u_register_t residency;
@@ -26,6 +25,34 @@ typedef struct psci_stat {
  */
 static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {-1};
 
+#if PSCI_STAT_HISTOGRAM
+/*
+ * The statistics block, shared with the normal world if the platform provides
+ * memory for it. It also serves the PSCI_STAT_RESIDENCY/COUNT calls.
+ */
+#ifdef PLAT_PSCI_STAT_SHM_BASE
+CASSERT(sizeof(psci_stat_shm_t) <= PLAT_PSCI_STAT_SHM_SIZE,
+	assert_psci_stat_shm_size);
+#define psci_stat_shm	((psci_stat_shm_t *)PLAT_PSCI_STAT_SHM_BASE)
+#else
+static psci_stat_shm_t psci_stat_shm_data;
+#define psci_stat_shm	(&psci_stat_shm_data)
+#endif
+
+/*
+ * Timestamp of the last low power state entry of each CPU, taken with the
+ * data cache off when entering a power down state. Each entry lives in a cache
+ * line of its own, so that maintenance on it never affects other data.
+ */
+typedef struct psci_stat_enter_ts {
+	unsigned long long ts;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_stat_enter_ts_t;
+
+static psci_stat_enter_ts_t psci_stat_enter_ts[PLATFORM_CORE_COUNT];
+
+/* Timestamp of the last wakeup of each CPU, always taken with the cache on */
+static unsigned long long psci_stat_wakeup_ts[PLATFORM_CORE_COUNT];
+#else
 /*
  * Following are used to store PSCI STAT values for
  * CPU and non CPU power domains.
@@ -34,6 +61,7 @@ static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
 				[PLAT_MAX_PWR_LVL_STATES];
 static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 				[PLAT_MAX_PWR_LVL_STATES];
+#endif /* PSCI_STAT_HISTOGRAM */
 
 /*
  * This functions returns the index into the `psci_stat_t` array given the
@@ -58,6 +86,108 @@ static int get_stat_idx(plat_local_state_t local_state, int pwr_lvl)
 	return idx;
 }
 
+#if PSCI_STAT_HISTOGRAM
+/* Return the histogram bucket of a duration, i.e. its base 2 logarithm */
+static unsigned int hist_bucket(unsigned long long ticks)
+{
+	unsigned int hi = (unsigned int)(ticks >> 32);
+	unsigned int lo = (unsigned int)ticks;
+
+	if (hi != 0U)
+		return PSCI_STAT_HIST_BUCKETS - 1U;
+	if (lo == 0U)
+		return 0U;
+
+	return 31U - (unsigned int)__builtin_clz(lo);
+}
+
+/* Lock-free update of one power state of a node, see psci_stat_shm_t */
+static void hist_node_update(psci_stat_hist_node_t *node, int stat_idx,
+			     unsigned long long residency,
+			     unsigned long long wakeup)
+{
+	psci_stat_hist_t *hist = &node->state[stat_idx];
+
+	node->seq++;
+	dmbish();
+
+	hist->residency += residency;
+	hist->count++;
+	hist->residency_hist[hist_bucket(residency)]++;
+	hist->wakeup_hist[hist_bucket(wakeup)]++;
+
+	dmbish();
+	node->seq++;
+}
+
+/*
+ * Return the timestamp of the last low power state entry of `cpu_idx`. If
+ * it was taken with the data cache off, any stale copy of its cache line must
+ * be dropped first unless the caches are kept on at power down. The line is
+ * cleaned as well as invalidated, as `cpu_idx` may be another CPU storing a
+ * new timestamp with its cache on.
+ */
+static unsigned long long get_enter_ts(unsigned int cpu_idx,
+				       const psci_power_state_t *state_info)
+{
+	psci_stat_enter_ts_t *enter = &psci_stat_enter_ts[cpu_idx];
+
+#if !HW_ASSISTED_COHERENCY
+	if (is_local_state_off(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]))
+		flush_dcache_range((uintptr_t)enter, sizeof(*enter));
+#endif
+	return enter->ts;
+}
+
+/* Initialise the header of the statistics block */
+void psci_stats_init(void)
+{
+	psci_stat_shm_t *shm = psci_stat_shm;
+
+	memset(shm, 0, sizeof(*shm));
+	shm->num_states = PLAT_MAX_PWR_LVL_STATES;
+	shm->num_cpus = PLATFORM_CORE_COUNT;
+	shm->num_non_cpu_nodes = PSCI_NUM_NON_CPU_PWR_DOMAINS;
+	shm->cntfrq = read_cntfrq_el0();
+	dmbish();
+	shm->version = PSCI_STAT_HIST_VERSION;
+}
+
+/*
+ * Capture the wakeup timestamp of the current CPU. This is done as early as
+ * possible on the wakeup path so that the time spent in the PSCI finishers
+ * can be accounted for as wakeup latency.
+ */
+void psci_stats_wakeup(void)
+{
+	psci_stat_wakeup_ts[plat_my_core_pos()] = read_cntpct_el0();
+}
+#endif /* PSCI_STAT_HISTOGRAM */
+
+/*******************************************************************************
+ * Capture the residency accounting start point before entering a low power
+ * state. With PSCI_STAT_HISTOGRAM the timestamp is kept by the generic code,
+ * otherwise the platform hook is used.
+ ******************************************************************************/
+void psci_stats_accounting_start(const psci_power_state_t *state_info)
+{
+#if PSCI_STAT_HISTOGRAM
+	psci_stat_enter_ts[plat_my_core_pos()].ts = read_cntpct_el0();
+#else
+	plat_psci_stat_accounting_start(state_info);
+#endif
+}
+
+/*******************************************************************************
+ * Capture the residency accounting end point after exiting a low power state.
+ ******************************************************************************/
+void psci_stats_accounting_stop(const psci_power_state_t *state_info)
+{
+#if !PSCI_STAT_HISTOGRAM
+	plat_psci_stat_accounting_stop(state_info);
+#endif
+}
+
 /*******************************************************************************
  * This function is passed the target local power states for each power
  * domain (state_info) between the current CPU domain and its ancestors until
@@ -107,7 +237,11 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
 	int stat_idx;
 	plat_local_state_t local_state;
+#if PSCI_STAT_HISTOGRAM
+	unsigned long long residency, wakeup_ts, wakeup;
+#else
 	u_register_t residency;
+#endif
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info);
@@ -116,6 +250,14 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	local_state = state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
 	stat_idx = get_stat_idx(local_state, PSCI_CPU_PWR_LVL);
 
+#if PSCI_STAT_HISTOGRAM
+	wakeup_ts = psci_stat_wakeup_ts[cpu_idx];
+	wakeup = read_cntpct_el0() - wakeup_ts;
+	residency = wakeup_ts - get_enter_ts(cpu_idx, state_info);
+
+	hist_node_update(&psci_stat_shm->cpu[cpu_idx], stat_idx, residency,
+			 wakeup);
+#else
 	/* Call into platform interface to calculate residency. */
 	residency = plat_psci_stat_get_residency(PSCI_CPU_PWR_LVL,
 	    state_info, cpu_idx);
@@ -123,6 +265,7 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	/* Update CPU stats. */
 	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
 	psci_cpu_stat[cpu_idx][stat_idx].count++;
+#endif
 
 	/*
 	 * Check what power domains above CPU were off
@@ -138,9 +281,15 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 
 		assert(last_cpu_in_non_cpu_pd[parent_idx] != -1);
 
+#if PSCI_STAT_HISTOGRAM
+		residency = wakeup_ts -
+			get_enter_ts(last_cpu_in_non_cpu_pd[parent_idx],
+				     state_info);
+#else
 		/* Call into platform interface to calculate residency. */
 		residency = plat_psci_stat_get_residency(lvl, state_info,
 		    last_cpu_in_non_cpu_pd[parent_idx]);
+#endif
 
 		/* Initialize back to reset value */
 		last_cpu_in_non_cpu_pd[parent_idx] = -1;
@@ -149,14 +298,45 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		stat_idx = get_stat_idx(local_state, lvl);
 
 		/* Update non cpu stats */
+#if PSCI_STAT_HISTOGRAM
+		hist_node_update(&psci_stat_shm->non_cpu[parent_idx], stat_idx,
+				 residency, wakeup);
+#else
 		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
 		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+#endif
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
 }
 
+#if PSCI_STAT_HISTOGRAM
+/*
+ * Take a consistent snapshot of the residency and count of one power state of
+ * a node, the residency being converted from counter ticks to microseconds.
+ */
+static void hist_node_read(const psci_stat_hist_node_t *node, int stat_idx,
+			   psci_stat_t *psci_stat)
+{
+	const volatile psci_stat_hist_node_t *vnode = node;
+	unsigned long long ticks, freq = psci_stat_shm->cntfrq;
+	uint32_t seq;
+
+	do {
+		seq = vnode->seq;
+		dmbish();
+		ticks = vnode->state[stat_idx].residency;
+		psci_stat->count = vnode->state[stat_idx].count;
+		dmbish();
+	} while (((seq & 1U) != 0U) || (seq != vnode->seq));
+
+	assert(freq != 0ULL);
+	psci_stat->residency = ((ticks / freq) * 1000000ULL) +
+			       (((ticks % freq) * 1000000ULL) / freq);
+}
+#endif /* PSCI_STAT_HISTOGRAM */
+
 /*******************************************************************************
  * This function returns the appropriate count and residency time of the
  * local state for the highest power level expressed in the `power_state`
@@ -203,10 +383,20 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 			parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 
 		/* Get the non cpu power domain stats */
+#if PSCI_STAT_HISTOGRAM
+		hist_node_read(&psci_stat_shm->non_cpu[parent_idx], stat_idx,
+			       psci_stat);
+#else
 		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
+#endif
 	} else {
 		/* Get the cpu power domain stats */
+#if PSCI_STAT_HISTOGRAM
+		hist_node_read(&psci_stat_shm->cpu[target_idx], stat_idx,
+			       psci_stat);
+#else
 		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+#endif
 	}
 
 	return PSCI_E_SUCCESS;
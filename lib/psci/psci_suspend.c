@@ -28,6 +28,10 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
 {
 	psci_power_state_t state_info;
 
+#if ENABLE_PSCI_STAT
+	psci_stats_wakeup();
+#endif
+
 	psci_acquire_pwr_domain_locks(end_pwrlvl,
 				cpu_idx);
 
@@ -39,7 +43,7 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
 	psci_get_target_local_pwr_states(end_pwrlvl, &state_info);
 
 #if ENABLE_PSCI_STAT
-	plat_psci_stat_accounting_stop(&state_info);
+	psci_stats_accounting_stop(&state_info);
 	psci_stats_update_pwr_up(end_pwrlvl, &state_info);
 #endif
 
@@ -204,7 +208,7 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	psci_plat_pm_ops->pwr_domain_suspend(state_info);
 
 #if ENABLE_PSCI_STAT
-	plat_psci_stat_accounting_start(state_info);
+	psci_stats_accounting_start(state_info);
 #endif
 
 exit:
@@ -76,3 +76,41 @@ int mem_region_in_array_chk(mem_region_t *tbl, size_t nregions,
 
 	return -1;
 }
+
+/*
+ * Same as mem_region_in_array_chk(), for a table whose regions are sorted by
+ * base address and do not overlap, so that the only region which can cover
+ * the range is the last one starting at or below addr. It is looked up with a
+ * binary search instead of walking the whole table. As with
+ * mem_region_in_array_chk(), a range crossing two adjacent regions is not
+ * covered.
+ */
+int mem_region_in_sorted_array_chk(const mem_region_t *tbl, size_t nregions,
+				   uintptr_t addr, size_t nbytes)
+{
+	size_t lo = 0, hi = nregions, mid;
+
+	assert(tbl);
+	assert(nbytes > 0);
+	assert(!check_uptr_overflow(addr, nbytes-1));
+
+	/* Find the last region starting at or below addr */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (tbl[mid].base <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == 0)
+		return -1;
+
+	tbl += lo - 1;
+	assert(tbl->nbytes > 0);
+	assert(!check_uptr_overflow(tbl->base, tbl->nbytes-1));
+	if ((addr + (nbytes - 1)) <= (tbl->base + (tbl->nbytes - 1)))
+		return 0;
+
+	return -1;
+}
@@ -60,6 +60,10 @@ ENABLE_PMF			:= 0
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
+# Flag to keep PSCI STATs as per power state residency and wakeup latency
+# histograms in a statistics block which can be shared with the normal world
+PSCI_STAT_HISTOGRAM		:= 0
+
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
@@ -116,6 +120,14 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Original format.
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to remember the last CPU standby state requested by each CPU, so that
+# requesting it again skips its validation.
+PSCI_STANDBY_STATE_CACHE	:= 0
+
+# Flag to coordinate the power states of the non CPU power domains with counts
+# of the requested states instead of plat_get_target_pwr_state().
+PSCI_STATE_VOTE_COUNTS		:= 0
+
 # By default, BL1 acts as the reset handler, not BL31
 RESET_TO_BL31			:= 0
 
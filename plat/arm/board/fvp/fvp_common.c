@@ -123,6 +123,7 @@ const mmap_region_t plat_arm_mmap[] = {
 	ARM_V2M_MAP_MEM_PROTECT,
 #if ENABLE_SPM
 	ARM_SPM_BUF_EL3_MMAP,
+	ARM_SP_IMAGE_NS_BUF_EL3_MMAP,
 #endif
 	{0}
 };
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <cassert.h>
 #include <debug.h>
 #include <mmio.h>
 #include <norflash.h>
@@ -19,6 +20,15 @@ static mem_region_t arm_ram_ranges[] = {
 #endif
 };
 
+/*
+ * arm_ram_ranges is searched with mem_region_in_sorted_array_chk(), so its
+ * regions must be sorted by base address and must not overlap.
+ */
+#ifdef AARCH64
+CASSERT(ARM_NS_DRAM1_BASE + ARM_NS_DRAM1_SIZE <= ARM_DRAM2_BASE,
+	assert_arm_ram_ranges_sorted);
+#endif
+
 /*******************************************************************************
  * Function that reads the content of the memory protect variable that
  * enables clearing of non secure memory when system boots. This variable
@@ -89,7 +99,7 @@ void arm_nor_psci_do_mem_protect(void)
  ******************************************************************************/
 int arm_psci_mem_protect_chk(uintptr_t base, u_register_t length)
 {
-	return mem_region_in_array_chk(arm_ram_ranges,
-				       ARRAY_SIZE(arm_ram_ranges),
-				       base, length);
+	return mem_region_in_sorted_array_chk(arm_ram_ranges,
+					      ARRAY_SIZE(arm_ram_ranges),
+					      base, length);
 }
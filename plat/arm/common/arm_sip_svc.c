@@ -9,6 +9,7 @@
 #include <plat_arm.h>
 #include <pmf.h>
 #include <runtime_svc.h>
+#include <spm_svc.h>
 #include <stdint.h>
 #include <uuid.h>
 
@@ -69,6 +70,15 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				handle);
 		}
 
+#if ENABLE_SPM
+	case ARM_SIP_SVC_MM_COMMUNICATE_BATCH:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		return spm_mm_communicate_batch(x1, x2, x3, handle);
+#endif
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -76,6 +86,11 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+#if ENABLE_SPM
+		/* MM_COMMUNICATE_BATCH call */
+		call_count += 1;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
@@ -11,6 +11,10 @@ CSS_LOAD_SCP_IMAGES	?=	1
 # By default, SCMI driver is disabled for CSS platforms
 CSS_USE_SCMI_SDS_DRIVER	?=	0
 
+# By default, the SCMI driver waits for the SCP to acknowledge each CPU power
+# state request
+CSS_SCMI_POSTED_PWR_STATE_SET	?=	0
+
 PLAT_INCLUDES		+=	-Iinclude/plat/arm/css/common			\
 				-Iinclude/plat/arm/css/common/aarch64
 
@@ -83,3 +87,7 @@ endif
 # Process CSS_USE_SCMI_SDS_DRIVER flag
 $(eval $(call assert_boolean,CSS_USE_SCMI_SDS_DRIVER))
 $(eval $(call add_define,CSS_USE_SCMI_SDS_DRIVER))
+
+# Process CSS_SCMI_POSTED_PWR_STATE_SET flag
+$(eval $(call assert_boolean,CSS_SCMI_POSTED_PWR_STATE_SET))
+$(eval $(call add_define,CSS_SCMI_POSTED_PWR_STATE_SET))
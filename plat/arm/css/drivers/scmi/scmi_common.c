@@ -10,17 +10,46 @@
 #include "scmi.h"
 #include "scmi_private.h"
 
+/*
+ * Private helper function to check the response to a posted command, which
+ * is left in the mailbox until the next command is written.
+ */
+static void scmi_check_posted_command(mailbox_mem_t *mbx_mem)
+{
+	int ret;
+
+	if (SCMI_MSG_GET_TOKEN(mbx_mem->msg_header) != SCMI_POSTED_TOKEN)
+		return;
+
+	SCMI_PAYLOAD_RET_VAL1(mbx_mem->payload, ret);
+	if ((ret != SCMI_E_QUEUED) && (ret != SCMI_E_SUCCESS)) {
+		ERROR("SCMI posted command 0x%x return 0x%x unexpected\n",
+				mbx_mem->msg_header, ret);
+		panic();
+	}
+}
+
 /*
  * Private helper function to get exclusive access to SCMI channel.
  */
 void scmi_get_channel(scmi_channel_t *ch)
 {
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
 	assert(ch->lock);
 	bakery_lock_get(ch->lock);
 
-	/* Make sure any previous command has finished */
-	assert(SCMI_IS_CHANNEL_FREE(
-			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	/*
+	 * Wait for the previous command to finish. Only a posted command can
+	 * still be in progress at this point.
+	 */
+	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
+		;
+
+	/* Read the response only after the channel has been seen free */
+	dmbld();
+
+	scmi_check_posted_command(mbx_mem);
 }
 
 /*
@@ -60,6 +89,39 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	dmbld();
 }
 
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP and
+ * release exclusive access to the channel without waiting for the response.
+ * The command must have been created with SCMI_POSTED_TOKEN, its response is
+ * checked by the next user of the channel.
+ */
+void scmi_post_command(scmi_channel_t *ch)
+{
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
+	assert(SCMI_MSG_GET_TOKEN(mbx_mem->msg_header) == SCMI_POSTED_TOKEN);
+
+	SCMI_MARK_CHANNEL_BUSY(mbx_mem->status);
+
+	/*
+	 * Ensure that any write to the SCMI payload area is seen by SCP before
+	 * we write to the doorbell register.
+	 */
+	dmbst();
+
+	SCMI_RING_DOORBELL(ch->info->db_reg_addr, ch->info->db_modify_mask,
+					ch->info->db_preserve_mask);
+
+	/*
+	 * Ensure that the write to the doorbell register is complete before
+	 * another CPU can take the channel.
+	 */
+	dmbsy();
+
+	assert(ch->lock);
+	bakery_lock_release(ch->lock);
+}
+
 /*
  * Private helper function to release exclusive access to SCMI channel.
  */
@@ -155,6 +217,9 @@ void *scmi_init(scmi_channel_t *ch)
 
 	bakery_lock_init(ch->lock);
 
+	/* Do not mistake a stale message for the response to a posted one */
+	((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->msg_header = 0;
+
 	ch->is_initialized = 1;
 
 	ret = scmi_proto_version(ch, SCMI_PWR_DMN_PROTO_ID, &version);
@@ -50,6 +50,34 @@ int scmi_pwr_state_set(void *p, uint32_t domain_id,
 	return ret;
 }
 
+/*
+ * API to set the SCMI power domain power state without waiting for the SCP to
+ * acknowledge the command. The response is checked when the channel is next
+ * used, and the function always returns SCMI_E_QUEUED.
+ */
+int scmi_pwr_state_set_posted(void *p, uint32_t domain_id,
+					uint32_t scmi_pwr_state)
+{
+	mailbox_mem_t *mbx_mem;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PWR_DMN_PROTO_ID,
+			SCMI_PWR_STATE_SET_MSG, SCMI_POSTED_TOKEN);
+	mbx_mem->len = SCMI_PWR_STATE_SET_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+	SCMI_PAYLOAD_ARG3(mbx_mem->payload, SCMI_PWR_STATE_SET_FLAG_ASYNC,
+						domain_id, scmi_pwr_state);
+
+	scmi_post_command(ch);
+
+	return SCMI_E_QUEUED;
+}
+
 /*
  * API to get the SCMI power domain power state.
  */
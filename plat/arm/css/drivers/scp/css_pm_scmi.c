@@ -61,6 +61,17 @@ typedef enum {
 	scmi_power_state_sleep = 2,
 } scmi_power_state_t;
 
+/*
+ * With CSS_SCMI_POSTED_PWR_STATE_SET, the CPU power state requests are posted
+ * to the SCP and the CPU does not wait for the SCP to acknowledge them. The
+ * responses are checked by the next user of the SCMI channel.
+ */
+#if CSS_SCMI_POSTED_PWR_STATE_SET
+#define css_scmi_pwr_state_set		scmi_pwr_state_set_posted
+#else
+#define css_scmi_pwr_state_set		scmi_pwr_state_set
+#endif
+
 /*
  * The global handle for invoking the SCMI driver APIs after the driver
  * has been initialized.
@@ -126,11 +137,11 @@ void css_scp_suspend(const psci_power_state_t *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	ret = css_scmi_pwr_state_set(scmi_handle,
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
 		scmi_pwr_state);
 
-	if (ret != SCMI_E_SUCCESS) {
+	if (ret != SCMI_E_QUEUED && ret != SCMI_E_SUCCESS) {
 		ERROR("SCMI set power state command return 0x%x unexpected\n",
 				ret);
 		panic();
@@ -166,7 +177,7 @@ void css_scp_off(const psci_power_state_t *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	ret = css_scmi_pwr_state_set(scmi_handle,
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
 		scmi_pwr_state);
 
@@ -195,7 +206,7 @@ void css_scp_on(u_register_t mpidr)
 	core_pos = plat_core_pos_by_mpidr(mpidr);
 	assert(core_pos >= 0 && core_pos < PLATFORM_CORE_COUNT);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	ret = css_scmi_pwr_state_set(scmi_handle,
 		plat_css_core_pos_to_scmi_dmn_id_map[core_pos],
 		scmi_pwr_state);
 
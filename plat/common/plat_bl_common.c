@@ -21,6 +21,7 @@
 #pragma weak bl2_plat_handle_pre_image_load
 #pragma weak bl2_plat_handle_post_image_load
 #pragma weak plat_try_next_boot_source
+#pragma weak plat_image_chunk_loaded
 
 void bl2_el3_plat_prepare_exit(void)
 {
@@ -53,6 +54,11 @@ int plat_try_next_boot_source(void)
 	return 0;
 }
 
+void plat_image_chunk_loaded(unsigned int image_id, uintptr_t image_base,
+			     size_t loaded, size_t image_size)
+{
+}
+
 #if !ERROR_DEPRECATED
 #pragma weak bl2_early_platform_setup2
 
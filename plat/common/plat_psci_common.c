@@ -10,7 +10,7 @@
 #include <pmf.h>
 #include <psci.h>
 
-#if ENABLE_PSCI_STAT && ENABLE_PMF
+#if ENABLE_PSCI_STAT && ENABLE_PMF && !PSCI_STAT_HISTOGRAM
 #pragma weak plat_psci_stat_accounting_start
 #pragma weak plat_psci_stat_accounting_stop
 #pragma weak plat_psci_stat_get_residency
@@ -131,7 +131,7 @@ u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 
 	return calc_stat_residency(pwrup_ts, pwrdn_ts);
 }
-#endif /* ENABLE_PSCI_STAT && ENABLE_PMF */
+#endif /* ENABLE_PSCI_STAT && ENABLE_PMF && !PSCI_STAT_HISTOGRAM */
 
 /*
  * The PSCI generic code uses this API to let the platform participate in state
@@ -26,3 +26,16 @@ endif
 
 # -----------------------------------------------------------------------------
 
+
+# Queue the boot output to a ring buffer which is written to the UART FIFO
+# in bursts, instead of waiting for the UART on each character.
+NXP_CONSOLE_BUFFERED	?= 0
+$(eval $(call assert_boolean,NXP_CONSOLE_BUFFERED))
+
+ifeq (${NXP_CONSOLE_BUFFERED},1)
+$(eval $(call add_define,NXP_CONSOLE_BUFFERED))
+CONSOLE_SOURCES		+=	drivers/console/aarch64/buffered_console.S	\
+				drivers/console/console_buffered.c
+endif
+
+# -----------------------------------------------------------------------------
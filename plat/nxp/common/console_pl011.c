@@ -12,6 +12,22 @@
 #include <plat_common.h>
 #include <utils.h>
 #include <debug.h>
+#if NXP_CONSOLE_BUFFERED
+#include <console_buffered.h>
+
+/* Size of the ring buffer of the boot console, a power of 2 */
+#ifndef NXP_CONSOLE_BUF_SIZE
+#define NXP_CONSOLE_BUF_SIZE	4096
+#endif
+
+static const console_buffered_ops_t console_ops = {
+	.tx_burst = console_pl011_core_tx_burst,
+	.flush = console_pl011_core_flush,
+};
+
+static console_buffered_t buffered_console;
+static uint8_t console_buf[NXP_CONSOLE_BUF_SIZE];
+#endif
 
 /*
  * Perform arm specific early platform setup. At this moment we only initialize
@@ -28,4 +44,17 @@ void plat_console_init(void)
 	console_pl011_register(NXP_CONSOLE_ADDR,
 			       (sys.freq_platform/NXP_UART_CLK_DIVIDER),
 			       NXP_CONSOLE_BAUDRATE, &console);
+
+#if NXP_CONSOLE_BUFFERED
+	/*
+	 * Queue the boot output to the buffered console, and keep writing the
+	 * runtime output and crashes straight to the UART. BL31 switches to
+	 * the runtime state in bl31_plat_runtime_setup().
+	 */
+	console_set_scope(&console.console,
+			  CONSOLE_FLAG_RUNTIME | CONSOLE_FLAG_CRASH);
+	console_buffered_register(&buffered_console, NXP_CONSOLE_ADDR,
+				  &console_ops, console_buf,
+				  sizeof(console_buf));
+#endif
 }
@@ -76,3 +76,12 @@ int plat_set_nv_ctr(void *cookie, unsigned int nv_ctr)
 {
 	return 0;
 }
+
+#ifdef NXP_CSF_HASH_ON_LOAD
+/* Hash the images prepended with a CSF header while they are loaded */
+void plat_image_chunk_loaded(unsigned int image_id, uintptr_t image_base,
+			     size_t loaded, size_t image_size)
+{
+	csf_hash_on_load(image_base, loaded, image_size);
+}
+#endif
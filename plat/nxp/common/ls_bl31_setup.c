@@ -214,6 +214,14 @@ void bl31_platform_setup(void)
 
 void bl31_plat_runtime_setup(void)
 {
+#if NXP_CONSOLE_BUFFERED
+	/*
+	 * The buffered console is only meant for the boot CPU, write it out
+	 * and leave the runtime output to the UART console.
+	 */
+	console_flush();
+	console_switch_state(CONSOLE_FLAG_RUNTIME);
+#endif
 }
 
 /*******************************************************************************
@@ -154,4 +154,8 @@ int validate_esbc_header(void *img_hdr, void **img_key, uint32_t *key_len,
 int calc_img_hash(struct csf_hdr *hdr, void *img_addr, uint32_t img_size,
 		  uint8_t *img_hash, uint32_t *hash_len);
 
+#ifdef NXP_CSF_HASH_ON_LOAD
+void csf_hash_on_load(uintptr_t image_base, size_t loaded, size_t image_size);
+#endif
+
 #endif
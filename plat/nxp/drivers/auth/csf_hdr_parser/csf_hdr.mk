@@ -16,6 +16,17 @@ PLAT_INCLUDES	+= -Iplat/nxp/drivers/auth/csf_hdr_parser/
 
 $(eval $(call add_define, CSF_HEADER_PREPENDED))
 
+# Hash the images while they are being loaded rather than once loaded
+NXP_CSF_HASH_ON_LOAD	?= 0
+$(eval $(call assert_boolean,NXP_CSF_HASH_ON_LOAD))
+
+ifeq (${NXP_CSF_HASH_ON_LOAD},1)
+$(eval $(call add_define,NXP_CSF_HASH_ON_LOAD))
+# Size of the chunks the images are read in, not less than CSF_HDR_SZ
+NXP_CSF_HASH_CHUNK_SIZE	?= 0x100000
+$(eval $(call add_define_val,PLAT_LOAD_IMAGE_CHUNK_SIZE,${NXP_CSF_HASH_CHUNK_SIZE}))
+endif
+
 
 # Path to CST directory is required to generate the CSF header
 # and prepend it to image before fip image gets generated
@@ -125,6 +125,161 @@ static int deploy_rotpk_hash_table(void *srk_buffer, uint16_t num_srk)
 	return 0;
 }
 
+#ifdef NXP_CSF_HASH_ON_LOAD
+/*
+ * Hash of the image being loaded. The CSF header and SRK table are hashed
+ * together with the start of the image once the header is in memory, then
+ * the image is hashed as it gets loaded, in multiples of the SHA256 block
+ * size, while the next chunk is being read. calc_img_hash() then only has
+ * to pick up the digest.
+ */
+static struct {
+	struct hash_stream hs;
+	/* Written by SEC, padded so that no other field shares its lines */
+	uint8_t hash[round_up(SHA256_BYTES, CACHE_WRITEBACK_GRANULE)]
+		__aligned(CACHE_WRITEBACK_GRANULE);
+	struct csf_hdr *hdr;
+	size_t image_size;
+	size_t loaded;
+	uint32_t srk_tbl_off;
+	uint32_t num_srk;
+	uint32_t hashed;	/* Bytes of the image hashed, past the header */
+	bool started;
+	bool failed;
+	bool done;
+} load_hash;
+
+/*
+ * Check that the CSF header of the image being loaded can be hashed. It is
+ * only authenticated later on, so only make sure that the parts to hash lie
+ * within the header area.
+ */
+static bool load_hash_hdr_valid(struct csf_hdr *hdr, size_t image_size)
+{
+	uint64_t srk_end;
+
+	if (image_size <= CSF_HDR_SZ)
+		return false;
+
+	if (memcmp(hdr->barker, barker_code, CSF_BARKER_LEN))
+		return false;
+
+	if ((hdr->len_kr.num_srk == 0) ||
+	    (hdr->len_kr.num_srk > MAX_KEY_ENTRIES))
+		return false;
+
+	srk_end = (uint64_t)hdr->srk_tbl_off +
+		  hdr->len_kr.num_srk * sizeof(struct srk_table);
+
+	return (sizeof(struct csf_hdr) <= CSF_HDR_SZ) &&
+	       (srk_end <= CSF_HDR_SZ);
+}
+
+/*
+ * Called each time a chunk of an image has been loaded at image_base, the
+ * first `loaded` bytes of the image being in memory.
+ */
+void csf_hash_on_load(uintptr_t image_base, size_t loaded, size_t image_size)
+{
+	struct csf_hdr *hdr = (void *)image_base;
+	uint8_t *img = (uint8_t *)image_base + CSF_HDR_SZ;
+	uint8_t *msg[3];
+	uint32_t msgsz[3];
+	uint32_t nmsg = 0, pre_len, avail, total, end;
+
+	/* Start over on a new image, or a new attempt to load one */
+	if ((hdr != load_hash.hdr) || (image_size != load_hash.image_size) ||
+	    (loaded <= load_hash.loaded)) {
+		hash_stream_init(&load_hash.hs);
+		load_hash.hdr = hdr;
+		load_hash.image_size = image_size;
+		load_hash.hashed = 0;
+		load_hash.started = false;
+		load_hash.failed = false;
+		load_hash.done = false;
+	}
+	load_hash.loaded = loaded;
+
+	if (load_hash.failed || (loaded < CSF_HDR_SZ))
+		return;
+
+	if (!load_hash.started) {
+		if (!load_hash_hdr_valid(hdr, image_size)) {
+			load_hash.failed = true;
+			return;
+		}
+		load_hash.srk_tbl_off = hdr->srk_tbl_off;
+		load_hash.num_srk = hdr->len_kr.num_srk;
+	}
+
+	pre_len = sizeof(struct csf_hdr) +
+		  load_hash.num_srk * sizeof(struct srk_table);
+	avail = loaded - CSF_HDR_SZ;
+
+	if (loaded == image_size) {
+		/* Last chunk, there is always at least one byte left */
+		if (!load_hash.started ||
+		    (hash_stream_final(&load_hash.hs, img + load_hash.hashed,
+				       avail - load_hash.hashed,
+				       load_hash.hash) != 0)) {
+			load_hash.failed = true;
+			return;
+		}
+		load_hash.done = true;
+		return;
+	}
+
+	/*
+	 * Hash up to the last full block, keeping at least one byte for the
+	 * final step.
+	 */
+	total = (pre_len + avail - 1) & ~(SHA256_DATA_SIZE - 1);
+	if ((total < (pre_len + load_hash.hashed)) ||
+	    (load_hash.started && (total == (pre_len + load_hash.hashed))))
+		return;
+	end = total - pre_len;
+
+	if (!load_hash.started) {
+		msg[nmsg] = (uint8_t *)hdr;
+		msgsz[nmsg++] = sizeof(struct csf_hdr);
+		msg[nmsg] = (uint8_t *)hdr + load_hash.srk_tbl_off;
+		msgsz[nmsg++] = load_hash.num_srk * sizeof(struct srk_table);
+	}
+	if (end != load_hash.hashed) {
+		msg[nmsg] = img + load_hash.hashed;
+		msgsz[nmsg++] = end - load_hash.hashed;
+	}
+
+	if (hash_stream_update(&load_hash.hs, msg, msgsz, nmsg) != 0) {
+		load_hash.failed = true;
+		return;
+	}
+	load_hash.started = true;
+	load_hash.hashed = end;
+}
+
+/* Return the digest computed while loading the image, if it is usable */
+static bool get_load_hash(struct csf_hdr *hdr, void *img_addr,
+			  uint32_t img_size, uint8_t *img_hash)
+{
+	bool match;
+
+	match = load_hash.done && (hdr == load_hash.hdr) &&
+		(img_addr == (uint8_t *)hdr + CSF_HDR_SZ) &&
+		((img_size + CSF_HDR_SZ) == load_hash.image_size) &&
+		(hdr->srk_tbl_off == load_hash.srk_tbl_off) &&
+		(hdr->len_kr.num_srk == load_hash.num_srk);
+
+	/* The digest is only good for one check */
+	load_hash.done = false;
+
+	if (match)
+		memcpy(img_hash, load_hash.hash, SHA256_BYTES);
+
+	return match;
+}
+#endif /* NXP_CSF_HASH_ON_LOAD */
+
 /*
  * Calculate hash of ESBC hdr and ESBC. This function calculates the
  * single hash of ESBC header and ESBC image
@@ -138,6 +293,13 @@ int calc_img_hash(struct csf_hdr *hdr,
 	unsigned int digest_size = SHA256_BYTES;
 	enum hash_algo algo = SHA256;
 
+#ifdef NXP_CSF_HASH_ON_LOAD
+	if (get_load_hash(hdr, img_addr, img_size, img_hash)) {
+		*hash_len = digest_size;
+		return 0;
+	}
+#endif
+
 	ret = hash_init(algo, &ctx);
 	/* Copy hash at destination buffer */
 	if (ret)
@@ -535,8 +535,12 @@ static int parse_spd(struct ddr_info *priv)
 				continue;
 			}
 			debug("addr 0x%x\n", addr);
+			/*
+			 * Only the first valid SPD is parsed, the others are
+			 * compared by their checksums, in the first 256 bytes.
+			 */
 			ret = read_spd(addr, &spd[spd_idx],
-				       sizeof(struct ddr4_spd));
+				       spd_idx ? 256 : sizeof(struct ddr4_spd));
 			if (ret) {	/* invalid */
 				debug("Invalid SPD at address 0x%x\n", addr);
 				continue;
@@ -32,7 +32,7 @@ int read_spd(unsigned char chip, void *buf, int len)
 
 	i2c_write(SPD_SPA0_ADDRESS, 0, 1, &dummy, 1);
 	ret = i2c_read(chip, 0, 1, buf, 256);
-	if (!ret) {
+	if (!ret && (len > 256)) {
 		i2c_write(SPD_SPA1_ADDRESS, 0, 1, &dummy, 1);
 		ret = i2c_read(chip, 0, 1, buf + 256, min(256, len - 256));
 	}
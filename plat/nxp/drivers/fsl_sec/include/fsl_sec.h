@@ -23,6 +23,12 @@ int sec_init(void);
 /* This function is used to submit jobs to JR */
 int run_descriptor_jr(struct job_descriptor *desc);
 
+/* This function is used to submit jobs to JR without waiting for them */
+int enq_descriptor_jr(struct job_descriptor *desc);
+
+/* This function is used to reap the jobs completed by SEC */
+int poll_descriptors_jr(void);
+
 /* This function is used to instatiate the HW RNG is already not instantiated */
 int hw_rng_instantiate(void);
 
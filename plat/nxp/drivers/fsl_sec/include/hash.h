@@ -10,6 +10,9 @@
 #define __HASH_H__
 
 #include <stdbool.h>
+#include <jobdesc.h>
+#include <sec_jr_driver.h>
+#include <utils_def.h>
 
 /* List of hash algorithms */
 enum hash_algo {
@@ -77,10 +80,34 @@ struct hash_ctx {
 	bool active;
 };
 
+/*
+ * SHA256 calculated over several jobs, e.g. while the message is being
+ * loaded. At most one job of a stream is in flight at any time, the MDHA
+ * context being saved in ctx between the jobs.
+ *
+ * ctx is only written by SEC. It is last and padded to whole cache lines, so
+ * that the fields written by the CPU never share a cache line with it.
+ */
+struct hash_stream {
+	struct job_descriptor jobdesc;
+	uint32_t status;
+	volatile bool busy;
+	bool started;
+	bool failed;
+	uint8_t ctx[round_up(HASH_STEP_CTX_SIZE, CACHE_WRITEBACK_GRANULE)]
+		__aligned(CACHE_WRITEBACK_GRANULE);
+};
+
 int hash_init(enum hash_algo algo, void **ctx);
 int hash_update(enum hash_algo algo, void *context, void *data_ptr,
 		unsigned int data_len);
 int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
 	       unsigned int hash_len);
 
+void hash_stream_init(struct hash_stream *hs);
+int hash_stream_update(struct hash_stream *hs, uint8_t **msg,
+		       uint32_t *msgsz, uint32_t nmsg);
+int hash_stream_final(struct hash_stream *hs, uint8_t *msg, uint32_t msgsz,
+		      uint8_t *hash_ptr);
+
 #endif
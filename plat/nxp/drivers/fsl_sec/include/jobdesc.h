@@ -9,6 +9,7 @@
 #ifndef __JOBDESC_H
 #define __JOBDESC_H
 
+#include <stdbool.h>
 #include <rsa.h>
 
 #define KEY_BLOB_SIZE 32
@@ -51,4 +52,30 @@ void cnstr_hash_jobdesc(uint32_t *desc, uint8_t *msg, uint32_t msgsz,
 void cnstr_jobdesc_pkha_rsaexp(uint32_t *desc,
 			       struct pk_in_params *pkin, uint8_t *out,
 			       uint32_t out_siz);
+
+/* Construct descriptor for SHA256 over a flat (non SG) buffer */
+void cnstr_sha256_jobdesc(uint32_t *desc, uint8_t *msg, uint32_t msgsz,
+			  uint8_t *digest);
+
+/* Steps of a SHA256 calculation spread over several descriptors */
+#define HASH_STEP_INIT		0x4
+#define HASH_STEP_UPDATE	0x0
+#define HASH_STEP_FINAL		0x8
+
+/* Size of the saved MDHA context: running digest and message length */
+#define HASH_STEP_CTX_SIZE	40
+
+/* Construct descriptor for one step of a SHA256 over several buffers */
+void cnstr_sha256_step_jobdesc(uint32_t *desc, uint32_t step, uint8_t *ctx,
+			       uint8_t **msg, uint32_t *msgsz, uint32_t nmsg,
+			       uint8_t *digest);
+
+/* AES modes supported by cnstr_aes_jobdesc */
+#define AES_MODE_ECB		0
+#define AES_MODE_CBC		1
+
+/* Construct descriptor for AES ECB/CBC encryption or decryption */
+int cnstr_aes_jobdesc(uint32_t *desc, uint32_t mode, bool encrypt,
+		      uint8_t *key, uint32_t key_len, uint8_t *iv,
+		      uint8_t *in, uint8_t *out, uint32_t len);
 #endif
@@ -145,6 +145,7 @@ int sec_release(void);
  *                                callback function
  *
  * @retval ::0                 is returned for successful execution
+ * @retval ::-EBUSY            is returned if the job ring is full
  * @retval ::-1                is returned if there is some enqueue failure
  */
 int enq_jr_desc(void *job_ring_handle, struct job_descriptor *jobdescr);
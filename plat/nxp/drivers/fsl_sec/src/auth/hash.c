@@ -161,3 +161,144 @@ int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
 	ctx->active = false;
 	return ret;
 }
+
+static void hash_stream_done(uint32_t *desc, uint32_t status, void *arg,
+			     void *job_ring)
+{
+	struct hash_stream *hs = arg;
+
+	hs->status = status;
+	dmbish();
+	hs->busy = false;
+}
+
+/* Wait for the job of the stream in flight, if any */
+static int hash_stream_wait(struct hash_stream *hs)
+{
+	while (hs->busy) {
+		if (poll_descriptors_jr() < 0) {
+			hs->failed = true;
+			return -1;
+		}
+	}
+
+#ifdef SEC_MEM_NON_COHERENT
+	/* Drop any line of the context fetched while SEC was writing it */
+	inv_dcache_range((uintptr_t)hs->ctx, sizeof(hs->ctx));
+#endif
+
+	if (hs->status != 0U)
+		hs->failed = true;
+
+	return hs->failed ? -1 : 0;
+}
+
+/***************************************************************************
+ * Function	: hash_stream_init
+ * Arguments	: hs - Stream context
+ * Return	: Void
+ * Description	: This function initializes a stream for SHA256 calculation,
+ *		  after waiting for the job of its previous use, if any
+ ***************************************************************************/
+void hash_stream_init(struct hash_stream *hs)
+{
+	(void)hash_stream_wait(hs);
+	memset(hs, 0, sizeof(struct hash_stream));
+	hs->jobdesc.callback = hash_stream_done;
+	hs->jobdesc.arg = hs;
+
+#ifdef SEC_MEM_NON_COHERENT
+	/* The context is not written by the CPU after this point */
+	flush_dcache_range((uintptr_t)hs->ctx, sizeof(hs->ctx));
+#endif
+}
+
+/***************************************************************************
+ * Function	: hash_stream_update
+ * Arguments	: hs - Stream context
+ *		  msg - Array of pointers to the message parts
+ *		  msgsz - Array of sizes of the message parts
+ *		  nmsg - Number of message parts
+ * Return	: -1 on error
+ *		  0 on SUCCESS
+ * Description	: This function submits the hashing of the next message
+ *		  parts and returns without waiting for it, once the previous
+ *		  job of the stream is complete. The total size of the parts
+ *		  must be a multiple of SHA256_DATA_SIZE and the parts must
+ *		  not be modified until the next call on the stream.
+ ***************************************************************************/
+int hash_stream_update(struct hash_stream *hs, uint8_t **msg,
+		       uint32_t *msgsz, uint32_t nmsg)
+{
+#ifdef SEC_MEM_NON_COHERENT
+	uint32_t i;
+#endif
+
+	if (hash_stream_wait(hs) != 0)
+		return -1;
+
+	cnstr_sha256_step_jobdesc(hs->jobdesc.desc,
+				  hs->started ? HASH_STEP_UPDATE :
+						HASH_STEP_INIT,
+				  hs->ctx, msg, msgsz, nmsg, NULL);
+
+#ifdef SEC_MEM_NON_COHERENT
+	for (i = 0; i < nmsg; i++)
+		flush_dcache_range((uintptr_t)msg[i], msgsz[i]);
+	dmbsy();
+#endif
+
+	hs->busy = true;
+	if (enq_descriptor_jr(&hs->jobdesc) != 0) {
+		ERROR("Error in Enqueue\n");
+		hs->busy = false;
+		hs->failed = true;
+		return -1;
+	}
+	hs->started = true;
+
+	return 0;
+}
+
+/***************************************************************************
+ * Function	: hash_stream_final
+ * Arguments	: hs - Stream context
+ *		  msg - Last part of the message, at least one byte
+ *		  msgsz - Size of the last part
+ *		  hash_ptr - Output digest, in cache lines of its own
+ * Return	: SUCCESS or FAILURE
+ * Description	: This function hashes the last part of the message and
+ *		  waits for the digest
+ ***************************************************************************/
+int hash_stream_final(struct hash_stream *hs, uint8_t *msg, uint32_t msgsz,
+		      uint8_t *hash_ptr)
+{
+	if (hash_stream_wait(hs) != 0)
+		return -1;
+
+	if (!hs->started || (msgsz == 0U))
+		return -1;
+
+	cnstr_sha256_step_jobdesc(hs->jobdesc.desc, HASH_STEP_FINAL, hs->ctx,
+				  &msg, &msgsz, 1, hash_ptr);
+
+#ifdef SEC_MEM_NON_COHERENT
+	flush_dcache_range((uintptr_t)msg, msgsz);
+	inv_dcache_range((uintptr_t)hash_ptr, SHA256_DIGEST_SIZE);
+	dmbsy();
+#endif
+
+	hs->busy = true;
+	if (run_descriptor_jr(&hs->jobdesc) != 0) {
+		ERROR("Error in running descriptor\n");
+		hs->failed = true;
+	}
+	hs->busy = false;
+
+#ifdef SEC_MEM_NON_COHERENT
+	inv_dcache_range((uintptr_t)hs->ctx, sizeof(hs->ctx));
+	inv_dcache_range((uintptr_t)hash_ptr, SHA256_DIGEST_SIZE);
+#endif
+
+	return hs->failed ? -1 : 0;
+}
@@ -7,6 +7,7 @@
  */
 
 #include <platform_def.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -19,6 +20,7 @@
 #include <fsl_sec.h>
 #include <jobdesc.h>
 #include <sec_hw_specific.h>
+#include <spinlock.h>
 
 /* Job ring 3 is reserved for usage by sec firmware */
 #define DEFAULT_JR	3
@@ -204,13 +206,42 @@ int sec_init(void)
 	return ret;
 }
 
-/* This function is used for sumbitting job to the Job Ring
- * [param] [in] - jobdesc to be submitted
- * Return - -1 in case of error and 0 in case of SUCCESS
+/* Job ring 3 is shared between the synchronous users (RNG, HUK, hash, RSA)
+ * and the asynchronous SiP crypto offload service, which may be driven
+ * from any core at runtime.
  */
-int run_descriptor_jr(struct job_descriptor *jobdesc)
+#ifdef IMAGE_BL31
+static spinlock_t jr_lock;
+#define jr_lock_get()		spin_lock(&jr_lock)
+#define jr_lock_release()	spin_unlock(&jr_lock)
+#else
+#define jr_lock_get()
+#define jr_lock_release()
+#endif
+
+/* Completion tracking for a descriptor submitted by run_descriptor_jr */
+struct sync_job {
+	user_callback callback;
+	void *arg;
+	uint32_t status;
+	volatile bool done;
+};
+
+static void sync_job_done(uint32_t *desc, uint32_t status, void *arg,
+			  void *job_ring)
 {
-	int i = 0, ret = 0;
+	struct sync_job *job = arg;
+
+	job->status = status;
+	if (job->callback)
+		job->callback(desc, status, job->arg, job_ring);
+	job->done = true;
+}
+
+/* Convert the descriptor words to SEC endianness and enqueue it */
+static int enqueue_desc(struct job_descriptor *jobdesc)
+{
+	int i = 0;
 	uint32_t *desc_addr = jobdesc->desc;
 	uint32_t desc_len = desc_length(jobdesc->desc);
 	uint32_t desc_word;
@@ -227,25 +258,134 @@ int run_descriptor_jr(struct job_descriptor *jobdesc)
 	dmbsy();
 #endif
 
-	ret = enq_jr_desc(job_ring, jobdesc);
+	return enq_jr_desc(job_ring, jobdesc);
+}
+
+/* Reset the job ring after a descriptor could not be completed, failing
+ * all the descriptors which were not reaped yet, so that SEC no longer
+ * accesses them once their owners are gone.
+ */
+static void reset_jr(void)
+{
+	struct sec_job_ring_t *jr = job_ring;
+	struct job_descriptor *jobdesc;
+	uint32_t *desc;
+
+	if (hw_reset_job_ring(jr) != 0) {
+		ERROR("SEC: failed to reset the job ring\n");
+		panic();
+	}
+
+	while (jr->cidx != jr->pidx) {
+		desc = ptov((phys_addr_t *)sec_read_addr(&jr->input_ring[jr->cidx]));
+		jobdesc = (struct job_descriptor *)((uint8_t *)desc -
+				offsetof(struct job_descriptor, desc));
+		if (jobdesc->callback != NULL)
+			jobdesc->callback(desc, SEC_PROCESSING_ERROR,
+					  jobdesc->arg, jr);
+		jr->cidx = SEC_CIRCULAR_COUNTER(jr->cidx, SEC_JOB_RING_SIZE);
+	}
+
+	/* The hardware restarts from the beginning of the rings */
+	jr->cidx = 0;
+	jr->pidx = 0;
+}
+
+/* This function is used for sumbitting job to the Job Ring
+ * [param] [in] - jobdesc to be submitted
+ * Return - -1 in case of error and 0 in case of SUCCESS
+ */
+int run_descriptor_jr(struct job_descriptor *jobdesc)
+{
+	int ret = 0;
+	int errors = 0;
+	struct sync_job job;
+
+	/* Other descriptors may be in flight on the same ring, so wait for
+	 * this one in particular rather than for any completion.
+	 */
+	job.callback = jobdesc->callback;
+	job.arg = jobdesc->arg;
+	job.status = 0;
+	job.done = false;
+	jobdesc->callback = sync_job_done;
+	jobdesc->arg = &job;
+
+	jr_lock_get();
+
+	/* The ring may be filled up with asynchronous descriptors, reap some
+	 * of them to make room.
+	 */
+	while ((ret = enqueue_desc(jobdesc)) == -EBUSY) {
+		if (dequeue_jr(job_ring, -1) == 0)
+			break;
+	}
 	if (ret == 0) {
 		VERBOSE("JR enqueue done...\n");
 	} else {
 		ERROR("Error in Enqueue\n");
-		return ret;
+		goto out;
 	}
 
 	VERBOSE("Dequeue in progress");
 
-	ret = dequeue_jr(job_ring, -1);
-	if (ret >= 0) {
-		VERBOSE("Dequeue of %x desc success\n", ret);
-		ret = 0;
-	} else {
-		ERROR("deq_ret %x\n", ret);
-		ret = -1;
+	/* The failure of another descriptor is reported to its own callback,
+	 * and as no descriptor can be enqueued while the lock is held, at most
+	 * SEC_JOB_RING_SIZE - 1 of them can fail before this one is reaped.
+	 * Anything else means that the ring is stuck: reset it so that this
+	 * descriptor is not left to SEC once we have returned.
+	 */
+	while (!job.done) {
+		ret = dequeue_jr(job_ring, -1);
+		if (ret > 0) {
+			VERBOSE("Dequeue of %x desc success\n", ret);
+		} else if ((ret == 0) || (++errors >= SEC_JOB_RING_SIZE)) {
+			ERROR("deq_ret %x\n", ret);
+			reset_jr();
+		}
 	}
 
+	ret = (job.status == 0U) ? 0 : -1;
+
+out:
+	jr_lock_release();
+	jobdesc->callback = job.callback;
+	jobdesc->arg = job.arg;
+	return ret;
+}
+
+/* This function submits a job to the Job Ring without waiting for it.
+ * The callback of @jobdesc is invoked from poll_descriptors_jr() once
+ * SEC has processed the descriptor, with a non zero status on error.
+ * Return - -EBUSY if the ring is full, -1 in case of error and 0 on SUCCESS
+ */
+int enq_descriptor_jr(struct job_descriptor *jobdesc)
+{
+	int ret;
+
+	jr_lock_get();
+	ret = enqueue_desc(jobdesc);
+	jr_lock_release();
+
+	return ret;
+}
+
+/* This function reaps the descriptors processed by SEC without blocking
+ * and invokes their callbacks.
+ * Return - number of descriptors reaped, -1 in case of error
+ */
+int poll_descriptors_jr(void)
+{
+	struct sec_job_ring_t *jr = job_ring;
+	int ret;
+
+	if (jr == NULL)
+		return -1;
+
+	jr_lock_get();
+	ret = hw_poll_job_ring(jr, -1);
+	jr_lock_release();
+
 	return ret;
 }
 
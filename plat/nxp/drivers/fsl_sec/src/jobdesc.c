@@ -302,3 +302,178 @@ void cnstr_hash_jobdesc(uint32_t *desc, uint8_t *msg, uint32_t msgsz,
 	}
 
 }
+
+/***************************************************************************
+ * Function	: cnstr_sha256_jobdesc
+ * Arguments	: desc - Pointer to Descriptor
+ *		  msg - Pointer to contiguous message
+ *		  msgsz - Size of message
+ *		  digest - Pointer to Output Digest
+ * Return	: Void
+ * Description	: Creates the descriptor for SHA256 HASH calculation on a
+ *		  flat buffer, i.e. without going through an SG table
+ ***************************************************************************/
+void cnstr_sha256_jobdesc(uint32_t *desc, uint8_t *msg, uint32_t msgsz,
+			  uint8_t *digest)
+{
+	phys_addr_t *ptr_addr_in, *ptr_addr_out;
+
+	ptr_addr_in = (void *)vtop(msg);
+	ptr_addr_out = (void *)vtop(digest);
+
+	desc_init(desc);
+	desc_add_word(desc, 0xb0800000);
+
+	/* Class2 SHA256 HASH, INITFINAL */
+	desc_add_word(desc, 0x8443000d);
+
+	if (msgsz > 0xffff) {
+		desc_add_word(desc, 0x24540000);	/* FIFO Load, EXT */
+		desc_add_ptr(desc, ptr_addr_in);	/* Pointer to msg */
+		desc_add_word(desc, msgsz);	/* Size */
+	} else {
+		desc_add_word(desc, 0x24140000 | msgsz);
+		desc_add_ptr(desc, ptr_addr_in);
+	}
+	desc_add_word(desc, 0x54200020);	/* Store 32 bytes of context */
+	desc_add_ptr(desc, ptr_addr_out);
+}
+
+/***************************************************************************
+ * Function	: cnstr_sha256_step_jobdesc
+ * Arguments	: desc - Pointer to Descriptor
+ *		  step - HASH_STEP_INIT, HASH_STEP_UPDATE or HASH_STEP_FINAL
+ *		  ctx - Pointer to the HASH_STEP_CTX_SIZE bytes MDHA context
+ *		  msg - Array of pointers to the message parts
+ *		  msgsz - Array of sizes of the message parts
+ *		  nmsg - Number of message parts
+ *		  digest - Pointer to Output Digest (HASH_STEP_FINAL only)
+ * Return	: Void
+ * Description	: Creates the descriptor for one step of a SHA256 HASH
+ *		  calculation. Except for HASH_STEP_FINAL, the total size of
+ *		  the message parts must be a multiple of SHA256_DATA_SIZE.
+ *		  The MDHA context is saved in ctx after HASH_STEP_INIT and
+ *		  HASH_STEP_UPDATE and restored from it before the next step.
+ ***************************************************************************/
+void cnstr_sha256_step_jobdesc(uint32_t *desc, uint32_t step, uint8_t *ctx,
+			       uint8_t **msg, uint32_t *msgsz, uint32_t nmsg,
+			       uint8_t *digest)
+{
+	phys_addr_t *ptr_addr_ctx;
+	uint32_t i, fifo_ld;
+
+	ptr_addr_ctx = (void *)vtop(ctx);
+
+	desc_init(desc);
+	desc_add_word(desc, 0xb0800000);
+
+	if (step != HASH_STEP_INIT) {
+		/* Load the saved context in Class2 context */
+		desc_add_word(desc, 0x14200000 | HASH_STEP_CTX_SIZE);
+		desc_add_ptr(desc, ptr_addr_ctx);
+	}
+
+	/* Class2 SHA256 HASH, INIT/UPDATE/FINALIZE */
+	desc_add_word(desc, 0x84430001 | step);
+
+	for (i = 0; i < nmsg; i++) {
+		/* Only the last part is flagged as last Class2 data */
+		fifo_ld = (i == nmsg - 1) ? 0x24140000 : 0x24100000;
+
+		if (msgsz[i] > 0xffff) {
+			desc_add_word(desc, fifo_ld | 0x00400000); /* EXT */
+			desc_add_ptr(desc, (void *)vtop(msg[i]));
+			desc_add_word(desc, msgsz[i]);
+		} else {
+			desc_add_word(desc, fifo_ld | msgsz[i]);
+			desc_add_ptr(desc, (void *)vtop(msg[i]));
+		}
+	}
+
+	if (step == HASH_STEP_FINAL) {
+		desc_add_word(desc, 0x54200020);	/* Store 32 bytes */
+		desc_add_ptr(desc, (void *)vtop(digest));
+	} else {
+		/* Save the context for the next step */
+		desc_add_word(desc, 0x54200000 | HASH_STEP_CTX_SIZE);
+		desc_add_ptr(desc, ptr_addr_ctx);
+	}
+}
+
+/***************************************************************************
+ * Function	: cnstr_aes_jobdesc
+ * Arguments	: desc - Pointer to Descriptor
+ *		  mode - AES_MODE_ECB or AES_MODE_CBC
+ *		  encrypt - true for encryption, false for decryption
+ *		  key - Pointer to the AES key
+ *		  key_len - Key length in bytes (16, 24 or 32)
+ *		  iv - Pointer to the 16 byte IV (CBC only)
+ *		  in - Pointer to Input
+ *		  out - Pointer to Output
+ *		  len - Length of data, multiple of the AES block size
+ * Return	: -1 on invalid parameters, 0 on SUCCESS
+ * Description	: Creates the descriptor for a Class1 AES operation
+ ***************************************************************************/
+int cnstr_aes_jobdesc(uint32_t *desc, uint32_t mode, bool encrypt,
+		      uint8_t *key, uint32_t key_len, uint8_t *iv,
+		      uint8_t *in, uint8_t *out, uint32_t len)
+{
+	phys_addr_t *ptr_addr_key, *ptr_addr_in, *ptr_addr_out;
+	uint32_t op;
+
+	if ((key_len != 16U) && (key_len != 24U) && (key_len != 32U))
+		return -1;
+	if ((len == 0U) || ((len & 0xfU) != 0U))
+		return -1;
+	if ((mode == AES_MODE_CBC) && (iv == NULL))
+		return -1;
+
+	ptr_addr_key = vtop((void *)key);
+	ptr_addr_in = vtop((void *)in);
+	ptr_addr_out = vtop((void *)out);
+
+	/* Class1 AES, INITFINAL */
+	op = 0x8210000c;
+	if (mode == AES_MODE_CBC)
+		op |= 0x100;	/* AAI CBC */
+	else if (mode == AES_MODE_ECB)
+		op |= 0x200;	/* AAI ECB */
+	else
+		return -1;
+
+	if (encrypt)
+		op |= 0x1;
+	else
+		op |= 0x1000;	/* AAI DK, key is loaded as an encrypt key */
+
+	desc_init(desc);
+	desc_add_word(desc, 0xb0800000);
+
+	/* Class1 key */
+	desc_add_word(desc, 0x02000000 | key_len);
+	desc_add_ptr(desc, ptr_addr_key);
+
+	if (mode == AES_MODE_CBC) {
+		/* Load 16 byte IV in Class1 context */
+		desc_add_word(desc, 0x12200010);
+		desc_add_ptr(desc, vtop((void *)iv));
+	}
+
+	desc_add_word(desc, op);
+
+	if (len > 0xffff) {
+		desc_add_word(desc, 0x22520000);	/* FIFO Load, EXT */
+		desc_add_ptr(desc, ptr_addr_in);
+		desc_add_word(desc, len);
+		desc_add_word(desc, 0x60700000);	/* FIFO Store, EXT */
+		desc_add_ptr(desc, ptr_addr_out);
+		desc_add_word(desc, len);
+	} else {
+		desc_add_word(desc, 0x22120000 | len);
+		desc_add_ptr(desc, ptr_addr_in);
+		desc_add_word(desc, 0x60300000 | len);
+		desc_add_ptr(desc, ptr_addr_out);
+	}
+
+	return 0;
+}
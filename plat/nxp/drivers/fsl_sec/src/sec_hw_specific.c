@@ -496,6 +496,11 @@ int hw_poll_job_ring(struct sec_job_ring_t *job_ring, int32_t limit)
 		job_ring->cidx = SEC_CIRCULAR_COUNTER(job_ring->cidx,
 						      SEC_JOB_RING_SIZE);
 
+		arg_addr = (phys_addr_t *) (current_desc - sizeof(void *));
+		fnptr = (phys_addr_t *) (current_desc -
+					 sizeof(void *) - sizeof(usercall));
+		arg = (void *)*(arg_addr);
+
 		if (sec_error_code) {
 			ERROR("desc at cidx %d\n ", job_ring->cidx);
 			ERROR("generated error %x\n", sec_error_code);
@@ -506,16 +511,18 @@ int hw_poll_job_ring(struct sec_job_ring_t *job_ring, int32_t limit)
 					      &do_driver_shutdown);
 			hw_remove_entries(job_ring, 1);
 
+			/* Let the owner of the descriptor know it failed */
+			if (*fnptr) {
+				usercall = (user_callback) *(fnptr);
+				(*usercall) ((uint32_t *) current_desc,
+					     sec_error_code, arg, job_ring);
+			}
 			return -1;
 		}
 		/* Signal that the job has been processed & the slot is free */
 		hw_remove_entries(job_ring, 1);
 		notified_descs_no++;
 
-		arg_addr = (phys_addr_t *) (current_desc - sizeof(void *));
-		fnptr = (phys_addr_t *) (current_desc -
-					 sizeof(void *) - sizeof(usercall));
-		arg = (void *)*(arg_addr);
 		if (*fnptr) {
 			VERBOSE("Callback Function called\n");
 			usercall = (user_callback) *(fnptr);
@@ -230,8 +230,9 @@ int enq_jr_desc(void *job_ring_handle, struct job_descriptor *jobdescr)
 
 	if (SEC_JOB_RING_IS_FULL(job_ring->pidx, job_ring->cidx,
 				 SEC_JOB_RING_SIZE, SEC_JOB_RING_SIZE)) {
-		ERROR("Job ring is full\n");
-		return -1;
+		/* Expected when descriptors are queued without waiting */
+		VERBOSE("Job ring is full\n");
+		return -EBUSY;
 	}
 
 	/* Set ptr in input ring to current descriptor  */
@@ -16,16 +16,84 @@
 #include <io.h>
 #include <delay_timer.h>
 #include <i2c.h>
+#include <plat_common.h>
 
 extern uint64_t get_timer_val(uint64_t start);
 
+#if NXP_I2C_SPEED
+/* The I2C module is clocked by the platform clock divided by this */
+#ifndef NXP_I2C_CLK_DIV
+#define NXP_I2C_CLK_DIV		2
+#endif
+
+/*
+ * SCL clock divider and the matching frequency divider register value. The
+ * I2C controller of the Layerscape SoCs encodes the divider like the Vybrid
+ * one: IBFD[7:6] selects a multiplier of 1, 2 or 4 applied to the divider
+ * selected by IBFD[5:0]. The last entry is the conservative I2C_FD_CONSERV.
+ */
+static const unsigned short i2c_clk_div[][2] = {
+	{ 20,	0x00 }, { 22,	0x01 }, { 24,	0x02 }, { 26,	0x03 },
+	{ 28,	0x04 }, { 30,	0x05 }, { 32,	0x09 }, { 34,	0x06 },
+	{ 36,	0x0A }, { 40,	0x07 }, { 44,	0x0C }, { 48,	0x0D },
+	{ 52,	0x43 }, { 56,	0x0E }, { 60,	0x45 }, { 64,	0x12 },
+	{ 68,	0x0F }, { 72,	0x13 }, { 80,	0x14 }, { 88,	0x15 },
+	{ 96,	0x19 }, { 104,	0x16 }, { 112,	0x1A }, { 128,	0x17 },
+	{ 136,	0x4F }, { 144,	0x1C }, { 160,	0x1D }, { 176,	0x55 },
+	{ 192,	0x1E }, { 208,	0x56 }, { 224,	0x22 }, { 240,	0x1F },
+	{ 256,	0x23 }, { 288,	0x24 }, { 320,	0x25 }, { 384,	0x26 },
+	{ 448,	0x2A }, { 480,	0x27 }, { 512,	0x2B }, { 576,	0x2C },
+	{ 640,	0x2D }, { 768,	0x2E }, { 896,	0x32 }, { 960,	0x2F },
+	{ 1024,	0x33 }, { 1152,	0x34 }, { 1280,	0x35 }, { 1536,	0x36 },
+	{ 1792,	0x3A }, { 1920,	0x37 }, { 2048,	0x3B }, { 2304,	0x3C },
+	{ 2560,	0x3D }, { 3072,	0x3E }, { 3584,	0x7A }, { 3840,	0x3F },
+	{ 4096,	0x7B }, { 4608,	0x7C }, { 5120,	0x7D },
+	{ 6144,	I2C_FD_CONSERV }
+};
+
+/*
+ * Return the frequency divider register value giving the fastest SCL clock
+ * not above NXP_I2C_SPEED.
+ */
+static unsigned char i2c_get_fd(void)
+{
+	struct sysinfo sys;
+	unsigned long clk, div;
+	int i;
+
+	get_clocks(&sys);
+	clk = sys.freq_platform / NXP_I2C_CLK_DIV;
+	div = (clk + NXP_I2C_SPEED - 1) / NXP_I2C_SPEED;
+
+	for (i = 0; i < ARRAY_SIZE(i2c_clk_div); i++) {
+		if (i2c_clk_div[i][0] >= div)
+			break;
+	}
+
+	/* The slowest SCL clock is the conservative setting */
+	if (i == ARRAY_SIZE(i2c_clk_div)) {
+		WARN("I2C: SCL %d Hz too low, using the slowest clock\n",
+		     NXP_I2C_SPEED);
+		return I2C_FD_CONSERV;
+	}
+
+	INFO("I2C clock %lu Hz, SCL %lu Hz\n", clk, clk / i2c_clk_div[i][0]);
+
+	return i2c_clk_div[i][1];
+}
+#endif
+
 void i2c_init(void)
 {
 	struct ls_i2c *ccsr_i2c = (void *)NXP_I2C_ADDR;
 
 	/* Presume workaround for erratum a009203 applied */
 	i2c_out(&ccsr_i2c->cr, I2C_CR_DIS);
+#if NXP_I2C_SPEED
+	i2c_out(&ccsr_i2c->fd, i2c_get_fd());
+#else
 	i2c_out(&ccsr_i2c->fd, I2C_FD_CONSERV);
+#endif
 	i2c_out(&ccsr_i2c->sr, I2C_SR_RST);
 	i2c_out(&ccsr_i2c->cr, I2C_CR_EN);
 }
@@ -50,7 +118,8 @@ static int wait_for_state(struct ls_i2c *ccsr_i2c,
 		timer = get_timer_val(start_time);
 		if (timer > I2C_TIMEOUT)
 			break;
-		mdelay(1);
+		/* A byte takes tens of us on the bus, do not sleep longer */
+		udelay(I2C_POLL_DELAY);
 	} while (1);
 	WARN("I2C: Timeout waiting for state 0x%x, sr = 0x%x\n", state, sr);
 
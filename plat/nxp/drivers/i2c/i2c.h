@@ -12,6 +12,7 @@
 #define __I2C_H__
 
 #define I2C_TIMEOUT	1000	/* ms */
+#define I2C_POLL_DELAY	1	/* us */
 
 #define I2C_FD_CONSERV	0x7e
 #define I2C_CR_DIS	(1 << 7)
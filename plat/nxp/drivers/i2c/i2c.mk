@@ -7,4 +7,9 @@
 I2C_DRIVERS_PATH        :=      plat/nxp/drivers/i2c
 
 BL2_SOURCES		+=  $(I2C_DRIVERS_PATH)/i2c.c
+
+# SCL clock frequency in Hz, e.g. 400000 for fast mode. The default of 0
+# keeps the most conservative divider.
+NXP_I2C_SPEED		?= 0
+$(eval $(call add_define,NXP_I2C_SPEED))
 PLAT_INCLUDES		+= -I$(I2C_DRIVERS_PATH)
@@ -10,6 +10,7 @@
 #ifndef __SIPSVC_H__
 #define __SIPSVC_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define SMC_FUNC_MASK			0x0000ffff
@@ -28,13 +29,19 @@
 #define SIP_SVC_ALLOW_L2_CLR		0xff16
 #define SIP_SVC_2_AARCH32		0xff17
 #define SIP_SVC_PORSR1			0xff18
+#define SIP_SVC_CRYPTO_SUBMIT		0xff19
+#define SIP_SVC_CRYPTO_STATUS		0xff1a
 
 /* Layerscape SiP Service Calls version numbers */
 #define LS_SIP_SVC_VERSION_MAJOR	0x0
 #define LS_SIP_SVC_VERSION_MINOR	0x1
 
 /* Number of Layerscape SiP Calls implemented */
+#ifdef NXP_SIP_CRYPTO_OFFLOAD
+#define LS_COMMON_SIP_NUM_CALLS		12
+#else
 #define LS_COMMON_SIP_NUM_CALLS		10
+#endif
 
 /* Parameter Type Constants */
 #define SIP_PARAM_TYPE_NONE		0x0
@@ -77,6 +84,7 @@ enum {
 	LS_SIP_SUCCESS = 0,
 	LS_SIP_INVALID_PARAM = -1,
 	LS_SIP_NOT_SUPPORTED = -2,
+	LS_SIP_BUSY = -3,
 };
 
 typedef struct {
@@ -97,4 +105,46 @@ typedef struct {
 	} u;
 } SIP_Param;
 
+/*
+ * Crypto offload command, as laid out by the caller in the shared memory
+ * command ring passed to SIP_SVC_CRYPTO_SUBMIT. All addresses are physical.
+ *
+ * SIP_CRYPTO_OP_SHA256:	dst[32] = SHA256(src[len])
+ * SIP_CRYPTO_OP_AES_*:		dst[len] = AES(key[key_len], iv[16], src[len])
+ * SIP_CRYPTO_OP_RSA_PUB:	dst[key_len] = src ^ e mod n, where key points
+ *				to n[key_len] followed by e[key_len]
+ */
+struct sip_crypto_cmd {
+	uint32_t op;
+	uint32_t status;	/* SIP_CRYPTO_STATUS_*, written by EL3 */
+	uint64_t src;
+	uint64_t dst;
+	uint64_t key;
+	uint64_t iv;
+	uint32_t len;
+	uint32_t key_len;
+};
+
+/* Crypto offload operations */
+#define SIP_CRYPTO_OP_SHA256		0x1
+#define SIP_CRYPTO_OP_AES_ECB_ENC	0x2
+#define SIP_CRYPTO_OP_AES_ECB_DEC	0x3
+#define SIP_CRYPTO_OP_AES_CBC_ENC	0x4
+#define SIP_CRYPTO_OP_AES_CBC_DEC	0x5
+#define SIP_CRYPTO_OP_RSA_PUB		0x6
+
+/* Crypto offload per command status */
+#define SIP_CRYPTO_STATUS_OK		0x0
+#define SIP_CRYPTO_STATUS_PENDING	0x1
+#define SIP_CRYPTO_STATUS_INVALID	0x2
+#define SIP_CRYPTO_STATUS_HW_ERROR	0x3
+
+/* Maximum number of commands in one SIP_SVC_CRYPTO_SUBMIT batch */
+#define SIP_CRYPTO_MAX_CMDS		256
+
+int sip_crypto_submit(uint64_t cmds, uint64_t num_cmds, bool ns,
+		      uint64_t *ticket);
+int sip_crypto_status(uint64_t ticket, bool ns, uint64_t *done,
+		      uint64_t *failed);
+
 #endif /* __SIPSVC_H__ */
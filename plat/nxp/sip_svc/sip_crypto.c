@@ -0,0 +1,373 @@
+/*
+ * Copyright 2018 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <assert.h>
+#include <arch_helpers.h>
+#include <debug.h>
+#include <sipsvc.h>
+#include <spinlock.h>
+#include <fsl_sec.h>
+#include <jobdesc.h>
+#include <rsa.h>
+#include <hash.h>
+#include <plat_common.h>
+
+/*
+ * Crypto offload service.
+ *
+ * A caller hands over a batch of commands in shared memory with
+ * SIP_SVC_CRYPTO_SUBMIT and gets a ticket back immediately. The commands are
+ * queued to the secure CAAM job ring, at most SIP_CRYPTO_MAX_INFLIGHT at a
+ * time, and the remaining ones are fed to the ring every time the service is
+ * entered. SIP_SVC_CRYPTO_STATUS reaps completed jobs and reports progress.
+ * Each command also gets its own status written back in shared memory.
+ */
+
+/* Number of batches which can be outstanding at any time */
+#define SIP_CRYPTO_MAX_BATCHES		4
+
+/* Keep a slot on the job ring free for the synchronous SEC users */
+#define SIP_CRYPTO_MAX_INFLIGHT		(SEC_JOB_RING_SIZE - 2)
+
+#define SIP_CRYPTO_TICKET_IDX_MASK	0xff
+#define SIP_CRYPTO_TICKET_GEN_SHIFT	8
+
+#define AES_IV_SIZE			16
+
+struct crypto_batch {
+	struct sip_crypto_cmd *cmds;
+	uint32_t num_cmds;
+	uint32_t next;		/* Next command to queue to the job ring */
+	uint32_t done;
+	uint32_t failed;
+	uint32_t gen;
+	bool ns;
+	bool busy;
+};
+
+struct crypto_job {
+	struct job_descriptor jobdesc;
+	struct crypto_batch *batch;
+	struct sip_crypto_cmd *cmd;
+	uint32_t status;
+	volatile bool done;
+	bool busy;
+};
+
+static struct crypto_batch batches[SIP_CRYPTO_MAX_BATCHES];
+static struct crypto_job jobs[SIP_CRYPTO_MAX_INFLIGHT];
+static uint32_t batch_gen;
+static spinlock_t crypto_lock;
+
+/*
+ * Called by the SEC driver when a job has been processed. This may happen
+ * on any core reaping the job ring, including synchronous SEC users, so
+ * only the job itself is updated here. The accounting is done under the
+ * service lock by reap_jobs().
+ */
+static void crypto_job_done(uint32_t *desc, uint32_t status, void *arg,
+			    void *job_ring)
+{
+	struct crypto_job *job = arg;
+
+	job->status = status;
+	dmbish();
+	job->done = true;
+}
+
+/* Check that [addr, addr + size) lies within a single non-secure DRAM bank */
+static bool is_ns_dram(uint64_t addr, uint64_t size)
+{
+	dram_regions_info_t *info = get_dram_regions_info();
+	uint64_t base, rsize;
+	int i;
+
+	if (size == 0U)
+		return false;
+
+	for (i = 0; i < info->num_dram_regions; i++) {
+		base = info->region[i].addr;
+		rsize = info->region[i].size;
+		if ((addr >= base) && (size <= rsize) &&
+		    ((addr - base) <= (rsize - size)))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Build the job descriptor for @cmd, which is a private copy of the
+ * command so that the caller cannot change it once validated.
+ */
+static int build_job_desc(struct crypto_job *job, struct sip_crypto_cmd *cmd,
+			  bool ns)
+{
+	uint32_t *desc = job->jobdesc.desc;
+	uint64_t in_sz = cmd->len, out_sz = cmd->len, key_sz = cmd->key_len;
+	uint64_t iv_sz = 0;
+	struct pk_in_params pkin;
+	bool encrypt = false;
+	uint32_t mode = AES_MODE_ECB;
+	int ret = 0;
+
+	switch (cmd->op) {
+	case SIP_CRYPTO_OP_SHA256:
+		out_sz = SHA256_DIGEST_SIZE;
+		key_sz = 0;
+		break;
+	case SIP_CRYPTO_OP_AES_CBC_ENC:
+	case SIP_CRYPTO_OP_AES_CBC_DEC:
+		mode = AES_MODE_CBC;
+		iv_sz = AES_IV_SIZE;
+		/* Fall through */
+	case SIP_CRYPTO_OP_AES_ECB_ENC:
+	case SIP_CRYPTO_OP_AES_ECB_DEC:
+		encrypt = (cmd->op == SIP_CRYPTO_OP_AES_ECB_ENC) ||
+			  (cmd->op == SIP_CRYPTO_OP_AES_CBC_ENC);
+		break;
+	case SIP_CRYPTO_OP_RSA_PUB:
+		if ((cmd->key_len == 0U) ||
+		    (cmd->key_len > RSA_4K_KEY_SZ_BYTES) ||
+		    (cmd->len != cmd->key_len))
+			return -1;
+		/* Modulus followed by the public exponent */
+		key_sz = 2U * cmd->key_len;
+		break;
+	default:
+		return -1;
+	}
+
+	if ((cmd->len == 0U) || (cmd->dst == 0U))
+		return -1;
+
+	if (ns) {
+		if (!is_ns_dram(cmd->src, in_sz) ||
+		    !is_ns_dram(cmd->dst, out_sz))
+			return -1;
+		if ((key_sz != 0U) && !is_ns_dram(cmd->key, key_sz))
+			return -1;
+		if ((iv_sz != 0U) && !is_ns_dram(cmd->iv, iv_sz))
+			return -1;
+	}
+
+	switch (cmd->op) {
+	case SIP_CRYPTO_OP_SHA256:
+		cnstr_sha256_jobdesc(desc, (uint8_t *)cmd->src, cmd->len,
+				     (uint8_t *)cmd->dst);
+		break;
+	case SIP_CRYPTO_OP_RSA_PUB:
+		memset(&pkin, 0, sizeof(pkin));
+		pkin.a = (uint8_t *)cmd->src;
+		pkin.a_siz = cmd->key_len;
+		pkin.n = (uint8_t *)cmd->key;
+		pkin.n_siz = cmd->key_len;
+		pkin.e = (uint8_t *)cmd->key + cmd->key_len;
+		pkin.e_siz = cmd->key_len;
+		cnstr_jobdesc_pkha_rsaexp(desc, &pkin, (uint8_t *)cmd->dst,
+					  cmd->key_len);
+		break;
+	default:
+		ret = cnstr_aes_jobdesc(desc, mode, encrypt,
+					(uint8_t *)cmd->key, cmd->key_len,
+					(uint8_t *)cmd->iv, (uint8_t *)cmd->src,
+					(uint8_t *)cmd->dst, cmd->len);
+		break;
+	}
+
+	if (ret != 0)
+		return ret;
+
+#ifdef SEC_MEM_NON_COHERENT
+	flush_dcache_range((uintptr_t)cmd->src, in_sz);
+	if (key_sz != 0U)
+		flush_dcache_range((uintptr_t)cmd->key, key_sz);
+	if (iv_sz != 0U)
+		flush_dcache_range((uintptr_t)cmd->iv, iv_sz);
+	inv_dcache_range((uintptr_t)cmd->dst, out_sz);
+	dmbsy();
+#endif
+
+	return 0;
+}
+
+static struct crypto_job *get_free_job(void)
+{
+	int i;
+
+	for (i = 0; i < SIP_CRYPTO_MAX_INFLIGHT; i++) {
+		if (!jobs[i].busy)
+			return &jobs[i];
+	}
+
+	return NULL;
+}
+
+/* Account for the jobs completed since the last call */
+static void reap_jobs(void)
+{
+	struct crypto_job *job;
+	int i;
+
+	poll_descriptors_jr();
+
+	for (i = 0; i < SIP_CRYPTO_MAX_INFLIGHT; i++) {
+		job = &jobs[i];
+		if (!job->busy || !job->done)
+			continue;
+
+		if (job->status != 0U) {
+			job->cmd->status = SIP_CRYPTO_STATUS_HW_ERROR;
+			job->batch->failed++;
+		} else {
+			job->cmd->status = SIP_CRYPTO_STATUS_OK;
+		}
+		job->batch->done++;
+		job->busy = false;
+	}
+}
+
+/* Queue as many pending commands as the job ring allows */
+static void feed_job_ring(void)
+{
+	struct crypto_batch *batch;
+	struct crypto_job *job;
+	struct sip_crypto_cmd cmd;
+	int i;
+
+	for (i = 0; i < SIP_CRYPTO_MAX_BATCHES; i++) {
+		batch = &batches[i];
+		if (!batch->busy)
+			continue;
+
+		while (batch->next < batch->num_cmds) {
+			job = get_free_job();
+			if (job == NULL)
+				return;
+
+			memcpy(&cmd, &batch->cmds[batch->next], sizeof(cmd));
+
+			job->batch = batch;
+			job->cmd = &batch->cmds[batch->next];
+			job->jobdesc.callback = crypto_job_done;
+			job->jobdesc.arg = job;
+			job->status = 0;
+			job->done = false;
+
+			if (build_job_desc(job, &cmd, batch->ns) != 0) {
+				job->cmd->status = SIP_CRYPTO_STATUS_INVALID;
+				batch->failed++;
+				batch->done++;
+				batch->next++;
+				continue;
+			}
+
+			job->busy = true;
+			if (enq_descriptor_jr(&job->jobdesc) != 0) {
+				/* Ring is full, retry on the next entry */
+				job->busy = false;
+				return;
+			}
+			batch->next++;
+		}
+	}
+}
+
+int sip_crypto_submit(uint64_t cmds, uint64_t num_cmds, bool ns,
+		      uint64_t *ticket)
+{
+	struct crypto_batch *batch = NULL;
+	uint32_t i;
+
+	if ((num_cmds == 0U) || (num_cmds > SIP_CRYPTO_MAX_CMDS))
+		return LS_SIP_INVALID_PARAM;
+
+	if ((cmds & (sizeof(uint64_t) - 1U)) != 0U)
+		return LS_SIP_INVALID_PARAM;
+
+	if (ns && !is_ns_dram(cmds, num_cmds * sizeof(struct sip_crypto_cmd)))
+		return LS_SIP_INVALID_PARAM;
+
+	spin_lock(&crypto_lock);
+
+	for (i = 0; i < SIP_CRYPTO_MAX_BATCHES; i++) {
+		if (!batches[i].busy) {
+			batch = &batches[i];
+			break;
+		}
+	}
+
+	if (batch == NULL) {
+		spin_unlock(&crypto_lock);
+		return LS_SIP_BUSY;
+	}
+
+	batch->cmds = (struct sip_crypto_cmd *)cmds;
+	batch->num_cmds = num_cmds;
+	batch->next = 0;
+	batch->done = 0;
+	batch->failed = 0;
+	batch->gen = ++batch_gen;
+	batch->ns = ns;
+	batch->busy = true;
+
+	for (i = 0; i < num_cmds; i++)
+		batch->cmds[i].status = SIP_CRYPTO_STATUS_PENDING;
+
+	*ticket = ((uint64_t)batch->gen << SIP_CRYPTO_TICKET_GEN_SHIFT) |
+		  (batch - batches);
+
+	reap_jobs();
+	feed_job_ring();
+
+	spin_unlock(&crypto_lock);
+
+	return LS_SIP_SUCCESS;
+}
+
+/*
+ * Report the progress of the batch identified by @ticket.
+ * Returns 0 once all its commands are processed, which also releases the
+ * ticket, 1 while some are still pending and a negative value on error.
+ */
+int sip_crypto_status(uint64_t ticket, bool ns, uint64_t *done,
+		      uint64_t *failed)
+{
+	struct crypto_batch *batch;
+	uint32_t idx = ticket & SIP_CRYPTO_TICKET_IDX_MASK;
+	int ret;
+
+	if (idx >= SIP_CRYPTO_MAX_BATCHES)
+		return LS_SIP_INVALID_PARAM;
+
+	spin_lock(&crypto_lock);
+
+	batch = &batches[idx];
+	if (!batch->busy || (batch->ns != ns) ||
+	    (batch->gen != (ticket >> SIP_CRYPTO_TICKET_GEN_SHIFT))) {
+		spin_unlock(&crypto_lock);
+		return LS_SIP_INVALID_PARAM;
+	}
+
+	reap_jobs();
+	feed_job_ring();
+
+	*done = batch->done;
+	*failed = batch->failed;
+
+	if (batch->done == batch->num_cmds) {
+		batch->busy = false;
+		ret = 0;
+	} else {
+		ret = 1;
+	}
+
+	spin_unlock(&crypto_lock);
+
+	return ret;
+}
@@ -71,6 +71,9 @@ uint64_t ls_sip_handler(uint32_t smc_fid,
 	uint32_t ns;
 	uint64_t ret;
 	dram_regions_info_t *info_dram_regions;
+#ifdef NXP_SIP_CRYPTO_OFFLOAD
+	uint64_t ticket, done, failed;
+#endif
 
 	/* if parameter is sent from SMC32. Clean top 32 bits */
 	clean_top_32b_of_param(smc_fid, &x1, &x2, &x3, &x4);
@@ -142,6 +145,29 @@ uint64_t ls_sip_handler(uint32_t smc_fid,
 	case SIP_SVC_PORSR1:
 		ret = bl31_get_porsr1();
 		SMC_RET2(handle, SMC_OK, ret);
+#ifdef NXP_SIP_CRYPTO_OFFLOAD
+	case SIP_SVC_CRYPTO_SUBMIT:
+		if (CHECK_SEC_DISABLED != 0) {
+			NOTICE("SEC is disabled.\n");
+			SMC_RET1(handle, SMC_UNK);
+		}
+		/* x1 - command ring address, x2 - number of commands */
+		ret = sip_crypto_submit(x1, x2, ns, &ticket);
+		if (ret == LS_SIP_SUCCESS) {
+			SMC_RET2(handle, SMC_OK, ticket);
+		} else {
+			SMC_RET1(handle, ret);
+		}
+	case SIP_SVC_CRYPTO_STATUS:
+		/* x1 - ticket returned by SIP_SVC_CRYPTO_SUBMIT */
+		ret = sip_crypto_status(x1, ns, &done, &failed);
+		if ((int)ret >= 0) {
+			/* x1 is 1 while commands are still pending */
+			SMC_RET4(handle, SMC_OK, ret, done, failed);
+		} else {
+			SMC_RET1(handle, ret);
+		}
+#endif
 	default :
 		return ls_plat_sip_handler(smc_fid, x1, x2, x3, x4,
 				cookie, handle, flags);
@@ -14,5 +14,14 @@
 SIPSVC_SOURCES	:=	${PLAT_SIPSVC_PATH}/sip_svc.c \
 			${PLAT_SIPSVC_PATH}/$(ARCH)/sipsvc.S
 
+# Asynchronous crypto offload through the CAAM job ring
+NXP_SIP_CRYPTO_OFFLOAD	?=	0
+$(eval $(call assert_boolean,NXP_SIP_CRYPTO_OFFLOAD))
+
+ifeq (${NXP_SIP_CRYPTO_OFFLOAD},1)
+$(eval $(call add_define,NXP_SIP_CRYPTO_OFFLOAD))
+SIPSVC_SOURCES	+=	${PLAT_SIPSVC_PATH}/sip_crypto.c
+endif
+
 # -----------------------------------------------------------------------------
 
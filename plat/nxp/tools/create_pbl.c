@@ -15,18 +15,7 @@
 #include <unistd.h>
 #include <getopt.h>
 
-#define NUM_MEM_BLOCK		1
-#define FOUR_BYTE_ALIGN		4
-#define EIGHT_BYTE_ALIGN	8
-#define SIZE_TWO_PBL_CMD	24
-
-/* Define for add_boot_ptr_cmd() */
-#define BOOTPTR_ADDR 0x09570604
-#define CSF_ADDR_SB 0x09ee0200
-/* CCSR write command to address 0x1e00400 i.e BOOTLOCPTR */
-#define BOOTPTR_ADDR_CH3 0x31e00400
-/* Load CSF header command */
-#define CSF_ADDR_SB_CH3 0x80220000
+#include "pbl_builder.h"
 
 #define	MAND_ARG_MASK				0xFFF3
 #define	ARG_INIT_MASK				0xFF00
@@ -39,234 +28,29 @@
 #define BL2_BIN_CPY_DEST_ADDR_ARG_MASK		0x0002
 #define OP_FILE_NAME_ARG_MASK			0x0001
 
-/* Define for add_cpy_cmd() */
-#define OFFSET_MASK		        0x00ffffff
-#define WRITE_CMD_BASE		    0x81000000
-#define MAX_PBI_DATA_LEN_BYTE	64
-
-/* 140 Bytes = Preamble + LOAD RCW command + RCW (128 bytes) + Checksum */
-#define CHS3_CRC_PAYLOAD_START_OFFSET 140
-
-#define PBI_CRC_POLYNOMIAL	0x04c11db7
-
-typedef enum {
-	CHASSIS_UNKNOWN,
-	CHASSIS_2,
-	CHASSIS_3,
-	CHASSIS_3_2,
-	CHASSIS_MAX    /* must be last item in list */
-} chassis_t;
-
-typedef enum {
-	UNKNOWN_BOOT = 0,
-	IFC_NOR_BOOT,
-	IFC_NAND_BOOT,
-	QSPI_BOOT,
-	SD_BOOT,
-	EMMC_BOOT,
-	FLXSPI_NOR_BOOT,
-	FLXSPI_NAND_BOOT,
-	FLXSPI_NAND4K_BOOT,
-	MAX_BOOT    /* must be last item in list */
-} boot_src_t;
-
-/* Base Addresses where PBL image is copied depending on the boot source.
- * Boot address map varies as per Chassis architecture.
- */
-#define BASE_ADDR_UNDEFINED  0xFFFFFFFF
-#define BASE_ADDR_QSPI       0x20000000
-#define BASE_ADDR_SD         0x00001000
-#define BASE_ADDR_IFC_NOR    0x30000000
-#define BASE_ADDR_EMMC       0x00001000
-#define BASE_ADDR_FLX_NOR    0x20000000
-#define BASE_ADDR_NAND       0x20000000
-
-uint32_t base_addr_ch3[MAX_BOOT] = {
-    BASE_ADDR_UNDEFINED,
-    BASE_ADDR_IFC_NOR,
-    BASE_ADDR_UNDEFINED,	/*IFC NAND */
-    BASE_ADDR_QSPI,
-    BASE_ADDR_SD,
-    BASE_ADDR_EMMC,
-    BASE_ADDR_UNDEFINED,	/*FLXSPI NOR */
-    BASE_ADDR_UNDEFINED,	/*FLXSPI NAND 2K */
-    BASE_ADDR_UNDEFINED		/*FLXSPI NAND 4K */
-};
-
-uint32_t base_addr_ch32[MAX_BOOT] = {
-    BASE_ADDR_UNDEFINED,
-    BASE_ADDR_UNDEFINED,	/* IFC NOR */
-    BASE_ADDR_UNDEFINED,	/* IFC NAND */
-    BASE_ADDR_UNDEFINED,	/* QSPI */
-    BASE_ADDR_SD,
-    BASE_ADDR_EMMC,
-    BASE_ADDR_FLX_NOR,
-    BASE_ADDR_UNDEFINED,	/*FLXSPI NAND 2K */
-    BASE_ADDR_UNDEFINED		/*FLXSPI NAND 4K */
-};
-
-/* for Chassis 3 */
-uint32_t blk_cpy_hdr_map_ch3[] = {
-
-	0,		    /* Unknown Boot Source */
-	0x80000020,	/* NOR_BOOT */
-	0x0,		/* NAND_BOOT */
-	0x80000062,	/* QSPI_BOOT */
-	0x80000040,	/* SD_BOOT */
-	0x80000041,	/* EMMC_BOOT */
-	0x0,		/* FLEXSPI NOR_BOOT */
-	0x0,	/* FLEX SPI NAND2K BOOT */
-	0x0,	/* CHASIS3_2_NAND4K_BOOT */
-};
+/* Longest line and maximum number of options on a line of a batch file */
+#define MAX_BATCH_LINE		4096
+#define MAX_BATCH_ARGS		64
 
-uint32_t blk_cpy_hdr_map_ch32[] = {
-	0,		    /* Unknown Boot Source */
-	0x0,		/* NOR_BOOT */
-	0x0,		/* NAND_BOOT */
-	0x0,		/* QSPI_BOOT */
-	0x80000008,	/* SD_BOOT */
-	0x80000009,	/* EMMC_BOOT */
-	0x8000000F,	/* FLEXSPI NOR_BOOT */
-	0x8000000C,	/* FLEX SPI NAND2K BOOT */
-	0x8000000D,	/* CHASIS3_2_NAND4K_BOOT */
+/* One PBL image to generate */
+struct pbl_job {
+	struct pbl_image img;
+	uint16_t args;		/* Arguments given, see *_ARG_MASK */
+	char *batch_nm;		/* Batch file */
 };
 
-char *boot_src_string[] = {
-	"UNKNOWN_BOOT",
-	"IFC_NOR_BOOT",
-	"IFC_NAND_BOOT",
-	"QSPI_BOOT",
-	"SD_BOOT",
-	"EMMC_BOOT",
-	"FLXSPI_NOR_BOOT",
-	"FLXSPI_NAND_BOOT",
-	"FLXSPI_NAND4K_BOOT",
-};
-
-enum stop_command {
-	STOP_COMMAND = 0,
-	CRC_STOP_COMMAND
-};
-
-/* Structure will get populated in the main function
- * as part of parsing the command line arguments.
- * All member parameters are mandatory except:
- *	-ep
- *	-src_addr
+/*
+ * Input files are read once and kept in memory, so that the RCW and BL2
+ * images shared by several images of a batch are not read again.
  */
-struct pbl_image {
-	char *rcw_nm;		/* Input RCW File */
-	char *sec_imgnm;	/* Input BL2 binary */
-	char *imagefile;	/* Generated output file */
-	boot_src_t boot_src;	/* Boot Source - QSPI, SD, NOR, NAND etc */
-	uint32_t src_addr;	/* Source Address */
-	uint32_t addr;		/* Load address */
-	uint32_t ep;		/* Entry point <opt> default is load address */
-	chassis_t chassis;	/* Chassis type */
-} pblimg;
-
-#define SUCCESS			 0
-#define FAILURE			-1
-#define CRC_STOP_CMD_ARM	0x08610040
-#define CRC_STOP_CMD_ARM_CH3	0x808f0000
-#define STOP_CMD_ARM_CH3	0x80ff0000
-#define BYTE_SWAP_32(word)	((((word) & 0xff000000) >> 24)|	\
-				(((word) & 0x00ff0000) >>  8) |	\
-				(((word) & 0x0000ff00) <<  8) |	\
-				(((word) & 0x000000ff) << 24))
-
-#define PBI_LEN_MASK	0xFFF00000
-#define PBI_LEN_SHIFT	20
-#define NUM_RCW_WORD	35
-#define PBI_LEN_ADD		6
-
-#define MAX_CRC_ENTRIES 256
-
-/* SoC numeric identifier */
-#define SOC_LS1012 1012
-#define SOC_LS1023 1023
-#define SOC_LS1026 1026
-#define SOC_LS1028 1028
-#define SOC_LS1043 1043
-#define SOC_LS1046 1046
-#define SOC_LS1088 1088
-#define SOC_LS2080 2080
-#define SOC_LS2088 2088
-#define SOC_LX2160 2160
-
-static uint32_t pbl_size;
-bool sb_flag = false;
-
-/***************************************************************************
- * Description	:	CRC32 Lookup Table
- ***************************************************************************/
-static uint32_t crc32_lookup[] = {
-	 0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA,
-	 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
-	 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
-	 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
-	 0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE,
-	 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-	 0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC,
-	 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
-	 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
-	 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
-	 0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940,
-	 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-	 0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116,
-	 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
-	 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
-	 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
-	 0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A,
-	 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-	 0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818,
-	 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
-	 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
-	 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
-	 0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C,
-	 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-	 0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2,
-	 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
-	 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
-	 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
-	 0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086,
-	 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-	 0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4,
-	 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
-	 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
-	 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
-	 0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8,
-	 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-	 0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE,
-	 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
-	 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
-	 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
-	 0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252,
-	 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-	 0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60,
-	 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
-	 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
-	 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
-	 0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04,
-	 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-	 0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A,
-	 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
-	 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
-	 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
-	 0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E,
-	 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-	 0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C,
-	 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
-	 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
-	 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
-	 0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0,
-	 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-	 0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6,
-	 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
-	 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
-	 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
-	};
+struct input_file {
+	struct input_file *next;
+	char *name;
+	uint8_t *data;
+	size_t len;
+};
 
+static struct input_file *input_files;
 
 static void print_usage(void)
 {
@@ -286,6 +70,9 @@ static void print_usage(void)
 	printf("\t                          command for chassis >=3.)\n");
 	printf("\t-e  <Address>           - [Optional] Entry Point Address\n");
 	printf("\t                          of the BL2.bin \n");
+	printf("\t-l  <Batch file-name>   - [Optional] Generate one PBL image\n");
+	printf("\t                          per line of options of the file,\n");
+	printf("\t                          other options being defaults.\n");
 	printf("\t-s  Secure Boot.\n");
 	printf("\t-h  Help.\n");
 	printf("\n\n");
@@ -294,523 +81,168 @@ static void print_usage(void)
 }
 
 /***************************************************************************
- * Function	:	crypto_calculate_checksum()
- * Arguments	:	data - Pointer to FILE
- *			num - Number of 32 bit words for checksum
- * Return	:	Checksum Value
- * Description	:	Calculate Checksum over the data
+ * Function	:	load_file
+ * Arguments	:	name - file name
+ * Return	:	File contents or NULL on failure
+ * Description	:	Read a whole input file, unless already read.
  ***************************************************************************/
-uint32_t crypto_calculate_checksum(FILE *fp_rcw_pbi_op, uint32_t num)
+static const struct input_file *load_file(const char *name)
 {
-	uint32_t i;
-	uint64_t sum = 0;
-	uint32_t word;
-
-	fseek(fp_rcw_pbi_op, 0L, SEEK_SET);
-	for (i = 0; i < num ; i++) {
-		if ((fread(&word, sizeof(word), NUM_MEM_BLOCK, fp_rcw_pbi_op))
-			< NUM_MEM_BLOCK) {
-			printf("%s: Error reading word.\n", __func__);
-			return FAILURE;
-		}
-		sum = sum + word;
-		sum = sum & 0xFFFFFFFF;
-	}
-	return (uint32_t)sum;
-}
-
-/***************************************************************************
- * Function	:	add_pbi_stop_cmd
- * Arguments	:	fp_rcw_pbi_op - output rcw_pbi file pointer
- * Return	:	SUCCESS or FAILURE
- * Description	:	This function insert pbi stop command.
- ***************************************************************************/
-int add_pbi_stop_cmd(FILE *fp_rcw_pbi_op, enum stop_command flag)
-{
-	int ret = FAILURE;
-	int32_t pbi_stop_cmd;
-	uint32_t pbi_crc = 0xffffffff, i, j, c;
-	uint32_t crc_table[MAX_CRC_ENTRIES];
-	uint8_t data;
-
-	switch (pblimg.chassis) {
-	case CHASSIS_2:
-		pbi_stop_cmd = BYTE_SWAP_32(CRC_STOP_CMD_ARM);
-		break;
-	case CHASSIS_3:
-	case CHASSIS_3_2:
-		/*Based on flag add the corresponsding cmd -- stop cmd or stop with CRC cmd */
-		if (flag == CRC_STOP_COMMAND){
-			pbi_stop_cmd = CRC_STOP_CMD_ARM_CH3;
-		} else {
-			pbi_stop_cmd = STOP_CMD_ARM_CH3;
-		}
-		break;
-	case CHASSIS_UNKNOWN:
-	case CHASSIS_MAX:
-	default:
-		printf("Internal Error: Invalid Chassis val = %d.\n",
-			pblimg.chassis);
-		goto pbi_stop_err;
-	}
+	struct input_file *file;
+	FILE *fp;
+	long size;
 
-	if (fwrite(&pbi_stop_cmd, sizeof(pbi_stop_cmd), NUM_MEM_BLOCK,
-			fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-		printf("%s: Error in Writing PBI STOP CMD\n", __func__);
-		goto pbi_stop_err;
+	for (file = input_files; file != NULL; file = file->next) {
+		if (!strcmp(file->name, name))
+			return file;
 	}
 
-	if(flag == CRC_STOP_COMMAND) {
-		for (i = 0; i < MAX_CRC_ENTRIES; i++) {
-			c = i << 24;
-			for (j = 0; j < 8; j++)
-				c = c & 0x80000000 ?
-				PBI_CRC_POLYNOMIAL ^ (c << 1) : c << 1;
+	fp = fopen(name, "rb");
+	if (fp == NULL)
+		return NULL;
 
-			crc_table[i] = c;
-		}
-	}
+	file = calloc(1, sizeof(*file));
+	if (file == NULL)
+		goto load_err;
 
-	switch (pblimg.chassis) {
-	case CHASSIS_2:
-		/* Chassis 2: CRC is calculated on  RCW + PBL cmd.*/
-		fseek(fp_rcw_pbi_op, 0L, SEEK_SET);
-		break;
-	case CHASSIS_3:
-	case CHASSIS_3_2:
-		/* Chassis 3: CRC is calculated on  PBL cmd only. */
-		fseek(fp_rcw_pbi_op, CHS3_CRC_PAYLOAD_START_OFFSET, SEEK_SET);
-		break;
-	case CHASSIS_UNKNOWN:
-	case CHASSIS_MAX:
-		printf("%s: Unknown Chassis.\n", __func__);
-		goto pbi_stop_err;
-	}
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((size = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0))
+		goto load_err;
 
-	while ((fread(&data, sizeof(data), NUM_MEM_BLOCK, fp_rcw_pbi_op))
-		== NUM_MEM_BLOCK) {
-		if(flag == CRC_STOP_COMMAND) {
-			if (pblimg.chassis == CHASSIS_2)
-				pbi_crc = crc_table
-					[((pbi_crc >> 24) ^ (data)) & 0xff]
-					^ (pbi_crc << 8);
-			else
-				pbi_crc =  (pbi_crc >> 8)
-					^ crc32_lookup[((pbi_crc)
-							^ (data)) & 0xff];
-		}
-	}
+	file->name = strdup(name);
+	file->data = malloc(size ? size : 1);
+	if ((file->name == NULL) || (file->data == NULL))
+		goto load_err;
 
-	switch (pblimg.chassis) {
-	case CHASSIS_2:
-		pbi_crc = BYTE_SWAP_32(pbi_crc);
-		break;
-	case CHASSIS_3:
-	case CHASSIS_3_2:
-		if(flag == CRC_STOP_COMMAND) {
-			pbi_crc = pbi_crc ^ 0xFFFFFFFF;
-		} else {
-			pbi_crc = 0x00000000;
-		}
-		break;
-	case CHASSIS_UNKNOWN:
-	case CHASSIS_MAX:
-		printf("%s: Unknown Chassis.\n", __func__);
-		goto pbi_stop_err;
-	}
+	file->len = size;
+	if (fread(file->data, 1, file->len, fp) != file->len)
+		goto load_err;
 
-	if (fwrite(&pbi_crc, sizeof(pbi_crc), NUM_MEM_BLOCK, fp_rcw_pbi_op)
-		!= NUM_MEM_BLOCK) {
-		printf("%s: Error in Writing PBI PBI CRC\n", __func__);
-		goto pbi_stop_err;
-	}
-	ret = SUCCESS;
+	fclose(fp);
 
-pbi_stop_err:
-	return ret;
-}
+	file->next = input_files;
+	input_files = file;
 
-/*
- * Returns:
- *     File size in bytes, on Success.
- *     FAILURE, on failure.
- */
-int get_filesize(const char *c)
-{
-	FILE *fp;
-    int ret = FAILURE;
+	return file;
 
-	fp = fopen(c, "rb");
-	if (fp == NULL) {
-		fprintf(stderr, "%s: Error in opening the file: %s\n",
-			__func__, c);
-		goto filesize_err;
+load_err:
+	fprintf(stderr, "%s: Error in reading the file: %s\n", __func__, name);
+	if (file != NULL) {
+		free(file->name);
+		free(file->data);
+		free(file);
 	}
-
-	fseek(fp, 0L, SEEK_END);
-	ret = ftell(fp);
 	fclose(fp);
-
-filesize_err:
-    return ret;
+	return NULL;
 }
 
-/***************************************************************************
- * Function	:	get_bootptr
- * Arguments	:	fp_rcw_pbi_op - Pointer to output file
- * Return	:	SUCCESS or FAILURE
- * Description	:	Add bootptr pbi command to output file
- ***************************************************************************/
-int add_boot_ptr_cmd(FILE *fp_rcw_pbi_op)
+static void free_files(void)
 {
-	uint32_t bootptr_addr;
-	int ret = FAILURE;
-
-	switch (pblimg.chassis) {
-	case CHASSIS_2:
-		if (sb_flag == true)
-			bootptr_addr = BYTE_SWAP_32(CSF_ADDR_SB);
-		else
-			bootptr_addr = BYTE_SWAP_32(BOOTPTR_ADDR);
-		pblimg.ep    = BYTE_SWAP_32(pblimg.ep);
-		break;
-	case CHASSIS_3:
-	case CHASSIS_3_2:
-		if (sb_flag == true)
-			bootptr_addr = CSF_ADDR_SB_CH3;
-		else
-			bootptr_addr = BOOTPTR_ADDR_CH3;
-		break;
-	case CHASSIS_UNKNOWN:
-	case CHASSIS_MAX:
-	default:
-		printf("Internal Error: Invalid Chassis val = %d.\n",
-			pblimg.chassis);
-		goto bootptr_err;
-	}
-
-	if (fwrite(&bootptr_addr, sizeof(bootptr_addr), NUM_MEM_BLOCK,
-		fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-		printf("%s: Error in Writing PBI Words:[%d].\n",
-			 __func__, ret);
-		goto bootptr_err;
+	struct input_file *file;
+
+	while (input_files != NULL) {
+		file = input_files;
+		input_files = file->next;
+		free(file->name);
+		free(file->data);
+		free(file);
 	}
-
-	if (pblimg.ep != 0) {
-		if (fwrite(&pblimg.ep, sizeof(pblimg.ep), NUM_MEM_BLOCK,
-			fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error in Writing PBI Words\n", __func__);
-			goto bootptr_err;
-		}
-	}
-
-	printf("\nBoot Location Pointer= %x\n", BYTE_SWAP_32(pblimg.ep));
-	ret = SUCCESS;
-
-bootptr_err:
-	return ret;
 }
 
 /***************************************************************************
- * Function	:	add_blk_cpy_cmd
- * Arguments	:	pbi_word - pointer to pbi commands
- *			args - Command  line args flag.
+ * Function	:	parse_args
+ * Arguments	:	argc, argv - options
+ *			job - image to update with the options
  * Return	:	SUCCESS or FAILURE
- * Description	:	Add pbi commands for block copy cmd in pbi_words
+ * Description	:	Parse the options of the command line or of a line
+ *			of the batch file.
  ***************************************************************************/
-int add_blk_cpy_cmd(FILE *fp_rcw_pbi_op, uint16_t args)
+static int parse_args(int argc, char **argv, struct pbl_job *job)
 {
-	uint32_t blk_cpy_hdr;
-	uint32_t file_size, new_file_size;
-	uint32_t align = 4;
-	int ret = FAILURE;
-	int num_pad_bytes = 0;
-
-	if ((args & BL2_BIN_STRG_LOC_BOOT_SRC_ARG_MASK) == 0) {
-		printf("ERROR: Offset not specified for Block Copy Cmd. \
-			See Usage and use -f option\n");
-		goto blk_copy_err;
-	}
-
-	switch (pblimg.chassis) {
-        case CHASSIS_3 :
-		/* Block copy command */
-		blk_cpy_hdr = blk_cpy_hdr_map_ch3[pblimg.boot_src];
-		pblimg.src_addr += base_addr_ch3[pblimg.boot_src];
-		break;
-        case CHASSIS_3_2 :
-		/* Block copy command */
-		blk_cpy_hdr = blk_cpy_hdr_map_ch32[pblimg.boot_src];
-		pblimg.src_addr += base_addr_ch32[pblimg.boot_src];
-		break;
-        default :
-		printf("%s: Error invalid chassis type for this command.\n",
-				__func__);
-		goto blk_copy_err;
-	}
-
-	file_size = get_filesize(pblimg.sec_imgnm);
-	if (file_size > 0) {
-		new_file_size = (file_size+(file_size % align));
-
-		/* Add Block copy command */
-		if (fwrite(&blk_cpy_hdr, sizeof(blk_cpy_hdr), NUM_MEM_BLOCK,
-			fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error writing blk_cpy_hdr to the file.\n",
-				 __func__);
-			goto blk_copy_err;
-		}
-
-		if ((args & BL2_BIN_STRG_LOC_BOOT_SRC_ARG_MASK) == 0)
-			num_pad_bytes = pblimg.src_addr % 4;
-
-		/* Add Src address word */
-		if (fwrite(&pblimg.src_addr + num_pad_bytes,
-			   sizeof(pblimg.src_addr), NUM_MEM_BLOCK,
-			   fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error writing BLK SRC Addr to the file.\n",
-				 __func__);
-			goto blk_copy_err;
-		}
-
-		/* Add Dest address word */
-		if (fwrite(&pblimg.addr, sizeof(pblimg.addr),
-			NUM_MEM_BLOCK, fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error writing DST Addr to the file.\n",
-			__func__);
-			goto blk_copy_err;
-		}
-
-		/* Add size */
-		if (fwrite(&new_file_size, sizeof(new_file_size),
-			NUM_MEM_BLOCK, fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error writing size to the file.\n",
-				__func__);
-			goto blk_copy_err;
-		}
-	}
-
-	ret = SUCCESS;
-
-blk_copy_err:
-	return ret;
-}
-
-/***************************************************************************
- * Function	:	add_cpy_cmd
- * Arguments	:	pbi_word - pointer to pbi commands
- * Return	:	SUCCESS or FAILURE
- * Description	:	Append pbi commands for copying BL2 image to the
- *			load address stored in pbl_image.addr
- ***************************************************************************/
-int add_cpy_cmd(FILE *fp_rcw_pbi_op)
-{
-	uint32_t ALTCBAR_ADDRESS = BYTE_SWAP_32(0x09570158);
-	uint32_t WAIT_CMD_WRITE_ADDRESS = BYTE_SWAP_32(0x096100c0);
-	uint32_t WAIT_CMD = BYTE_SWAP_32(0x000FFFFF);
-	int file_size;
-	uint32_t pbi_cmd, altcbar;
-	uint8_t pbi_data[MAX_PBI_DATA_LEN_BYTE];
-	uint32_t dst_offset;
-	FILE *fp_img = NULL;
-	int   ret    = FAILURE;
-
-	altcbar = pblimg.addr;
-	dst_offset = pblimg.addr;
-	fp_img = fopen(pblimg.sec_imgnm, "rb");
-	if (fp_img == NULL) {
-		printf("%s: Error in opening the file: %s\n", __func__,
-		      pblimg.sec_imgnm);
-		goto add_cpy_err;
-	}
-	file_size = get_filesize(pblimg.sec_imgnm);
-	altcbar = 0xfff00000 & altcbar;
-	altcbar = BYTE_SWAP_32(altcbar >> 16);
-	if (fwrite(&ALTCBAR_ADDRESS, sizeof(ALTCBAR_ADDRESS), NUM_MEM_BLOCK,
-		fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-		printf("%s: Error in writing address of ALTCFG CMD.\n",
-			 __func__);
-		goto add_cpy_err;
-	}
-	if (fwrite(&altcbar, sizeof(altcbar), NUM_MEM_BLOCK, fp_rcw_pbi_op)
-		!= NUM_MEM_BLOCK) {
-		printf("%s: Error in writing ALTCFG CMD.\n", __func__);
-		goto add_cpy_err;
-	}
-	if (fwrite(&WAIT_CMD_WRITE_ADDRESS, sizeof(WAIT_CMD_WRITE_ADDRESS),
-		NUM_MEM_BLOCK, fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-		printf("%s: Error in writing address of WAIT_CMD.\n",
-			__func__);
-		goto add_cpy_err;
-	}
-	if (fwrite(&WAIT_CMD, sizeof(WAIT_CMD), NUM_MEM_BLOCK, fp_rcw_pbi_op)
-		!= NUM_MEM_BLOCK) {
-		printf("%s: Error in writing WAIT_CMD.\n", __func__);
-		goto add_cpy_err;
-	}
-	do {
-		memset(pbi_data, 0, MAX_PBI_DATA_LEN_BYTE);
-
-		ret = fread(&pbi_data, MAX_PBI_DATA_LEN_BYTE,
-				NUM_MEM_BLOCK, fp_img);
-		if ((ret != NUM_MEM_BLOCK) && (!feof(fp_img))) {
-			printf("%s: Error writing ALTCFG Word: [%d].\n",
-				__func__, ret);
-			goto add_cpy_err;
-		}
-
-		dst_offset &= OFFSET_MASK;
-		pbi_cmd = WRITE_CMD_BASE | dst_offset;
-		pbi_cmd = BYTE_SWAP_32(pbi_cmd);
-		if (fwrite(&pbi_cmd, sizeof(pbi_cmd), NUM_MEM_BLOCK,
-			fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error writing ALTCFG Word write cmd.\n",
-				 __func__);
-			goto add_cpy_err;
-		}
-		if (fwrite(&pbi_data,  MAX_PBI_DATA_LEN_BYTE, NUM_MEM_BLOCK,
-			fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-			printf("%s: Error writing ALTCFG_Word.\n", __func__);
-			goto add_cpy_err;
-		}
-		dst_offset += MAX_PBI_DATA_LEN_BYTE;
-		file_size -= MAX_PBI_DATA_LEN_BYTE;
-	} while (!feof(fp_img));
-
-	ret = SUCCESS;
-
-add_cpy_err:
-    if (fp_img != NULL)
-	    fclose(fp_img);
-	return ret;
-}
-
-int main(int argc, char **argv)
-{
-	FILE *file = NULL;
+	struct pbl_image *pblimg = &job->img;
 	char *ptr;
 	int opt;
 	int tmp;
-	uint16_t args = ARG_INIT_MASK;
-	FILE *fp_rcw_pbi_ip = NULL, *fp_rcw_pbi_op = NULL;
-	uint32_t word, word_1;
-	int ret = FAILURE;
-	bool bootptr_flag = false;
-	enum stop_command flag_stop_cmd = CRC_STOP_COMMAND;;
 
-	/* Initializing the global structure to zero. */
-	memset(&pblimg, 0x0, sizeof(struct pbl_image));
+	/* Restart the scanning, as it is done once per batch line */
+	optind = 0;
 
 	while ((opt = getopt(argc, argv,
-			     ":b:f:r:i:e:d:c:o:h:s")) != -1) {
+			     ":b:f:r:i:e:d:c:o:h:sl:")) != -1) {
 		switch (opt) {
 		case 'd':
-			pblimg.addr = strtoull(optarg, &ptr, 16);
+			pblimg->addr = strtoull(optarg, &ptr, 16);
 			if (*ptr) {
 				fprintf(stderr,
-                        		"CMD Error: invalid load/destination address %s\n", optarg);
-                		goto exit_main;
+					"CMD Error: invalid load/destination address %s\n", optarg);
+				return FAILURE;
 			}
-			args |= BL2_BIN_CPY_DEST_ADDR_ARG_MASK;
+			job->args |= BL2_BIN_CPY_DEST_ADDR_ARG_MASK;
 			break;
 		case 'r':
-			pblimg.rcw_nm = optarg;
-			file = fopen(pblimg.rcw_nm, "r");
-			if (file == NULL) {
+			pblimg->rcw_nm = optarg;
+			if (load_file(pblimg->rcw_nm) == NULL) {
 				printf("CMD Error: Opening the RCW File.\n");
-               			 goto exit_main;
-			} else {
-				args |= RCW_FILE_NAME_ARG_MASK;
-				fclose(file);
+				return FAILURE;
 			}
+			job->args |= RCW_FILE_NAME_ARG_MASK;
 			break;
 		case 'e':
-			bootptr_flag = true;
-			pblimg.ep = strtoull(optarg, &ptr, 16);
+			pblimg->bootptr = true;
+			pblimg->ep = strtoull(optarg, &ptr, 16);
 			if (*ptr) {
 				fprintf(stderr,
-					    "CMD Error: Invalid entry point %s\n", optarg);
-                		goto exit_main;
+					"CMD Error: Invalid entry point %s\n", optarg);
+				return FAILURE;
 			}
 			break;
 		case 'h':
 			print_usage();
 			break;
 		case 'i':
-			pblimg.sec_imgnm = optarg;
-			file = fopen(pblimg.sec_imgnm, "r");
-			if (!file) {
+			pblimg->sec_imgnm = optarg;
+			if (load_file(pblimg->sec_imgnm) == NULL) {
 				printf("CMD Error: Opening Input file.\n");
-                		goto exit_main;
-			} else {
-				args |= IN_FILE_NAME_ARG_MASK;
-				fclose(file);
+				return FAILURE;
 			}
+			job->args |= IN_FILE_NAME_ARG_MASK;
 			break;
 		case 'c':
 			tmp = atoi(optarg);
-			switch (tmp) {
-			case SOC_LS1012:
-			case SOC_LS1023:
-			case SOC_LS1026:
-			case SOC_LS1043:
-			case SOC_LS1046:
-				pblimg.chassis = CHASSIS_2;
-				break;
-			case SOC_LS1088:
-			case SOC_LS2080:
-			case SOC_LS2088:
-				pblimg.chassis = CHASSIS_3;
-				break;
-			case SOC_LS1028:
-			case SOC_LX2160:
-				pblimg.chassis = CHASSIS_3_2;
-				break;
-			default:
+			pblimg->chassis = pbl_soc_chassis(tmp);
+			if (pblimg->chassis == CHASSIS_UNKNOWN) {
 				printf("CMD Error: Invalid SoC Val = %d.\n", tmp);
-                		goto exit_main;
+				return FAILURE;
 			}
-
-			args |= CHASSIS_ARG_MASK;
+			job->args |= CHASSIS_ARG_MASK;
 			break;
 		case 'o':
-			pblimg.imagefile = optarg;
-			args |= OP_FILE_NAME_ARG_MASK;
+			pblimg->imagefile = optarg;
+			job->args |= OP_FILE_NAME_ARG_MASK;
 			break;
 		case 's':
-			sb_flag = true;
+			pblimg->sb = true;
 			break;
 		case 'b':
-			if (!strcmp(optarg, "qspi"))
-				pblimg.boot_src = QSPI_BOOT;
-			else if (!strcmp(optarg, "nor"))
-				pblimg.boot_src = IFC_NOR_BOOT;
-			else if (!strcmp(optarg, "nand"))
-				pblimg.boot_src = IFC_NAND_BOOT;
-			else if (!strcmp(optarg, "sd"))
-				pblimg.boot_src = SD_BOOT;
-			else if (!strcmp(optarg, "emmc"))
-				pblimg.boot_src = EMMC_BOOT;
-			else if (!strcmp(optarg, "flexspi_nor"))
-				pblimg.boot_src = FLXSPI_NOR_BOOT;
-			else if (!strcmp(optarg, "flexspi_nand"))
-				pblimg.boot_src = FLXSPI_NAND_BOOT;
-			else if (!strcmp(optarg, "flexspi_nand2k"))
-				pblimg.boot_src = FLXSPI_NAND4K_BOOT;
-			else {
+			pblimg->boot_src = pbl_boot_src(optarg);
+			if (pblimg->boot_src == UNKNOWN_BOOT) {
 				printf("CMD Error: Invalid boot source.\n");
-                		goto exit_main;
+				return FAILURE;
 			}
-			args |= BOOT_SRC_ARG_MASK;
+			job->args |= BOOT_SRC_ARG_MASK;
 			break;
 		case 'f':
-			pblimg.src_addr = strtoull(optarg, &ptr, 16);
+			pblimg->src_addr = strtoull(optarg, &ptr, 16);
 			if (*ptr) {
 				fprintf(stderr,
-					    "CMD Error: Invalid src offset %s\n", optarg);
-		                goto exit_main;
+					"CMD Error: Invalid src offset %s\n", optarg);
+				return FAILURE;
 			}
-			args |= BL2_BIN_STRG_LOC_BOOT_SRC_ARG_MASK;
+			pblimg->src_addr_valid = true;
+			job->args |= BL2_BIN_STRG_LOC_BOOT_SRC_ARG_MASK;
+			break;
+		case 'l':
+			job->batch_nm = optarg;
 			break;
 		default:
 			/* issue a warning and skip the unknown arg */
@@ -818,170 +250,170 @@ int main(int argc, char **argv)
 		}
 	}
 
-	if ((args & MAND_ARG_MASK) != MAND_ARG_MASK)
-		print_usage();
+	return SUCCESS;
+}
 
-	fp_rcw_pbi_ip = fopen(pblimg.rcw_nm, "rb");
-	if (fp_rcw_pbi_ip == NULL) {
-		printf("%s: Error in opening the rcw file: %s\n",
-			__func__, pblimg.rcw_nm);
-		goto exit_main;
-	}
+/***************************************************************************
+ * Function	:	create_pbl
+ * Arguments	:	job - image to generate
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	Build the PBL image in memory and write it out.
+ ***************************************************************************/
+static int create_pbl(const struct pbl_job *job)
+{
+	const struct pbl_image *pblimg = &job->img;
+	const struct input_file *rcw, *bl2;
+	struct pbl_buf out = { 0 };
+	FILE *fp_rcw_pbi_op;
+	int ret = FAILURE;
+
+	rcw = load_file(pblimg->rcw_nm);
+	bl2 = load_file(pblimg->sec_imgnm);
+	if ((rcw == NULL) || (bl2 == NULL))
+		return FAILURE;
 
-	fp_rcw_pbi_op = fopen(pblimg.imagefile, "wb+");
+	printf("\nInput Boot Source: %s\n",
+	       pbl_boot_src_string(pblimg->boot_src));
+	printf("Input RCW File: %s\n", pblimg->rcw_nm);
+	printf("Input BL2 Binary File: %s\n", pblimg->sec_imgnm);
+	printf("Input load address for BL2 Binary File: 0x%x\n", pblimg->addr);
+	printf("Chassis Type: %d\n", pblimg->chassis);
+
+	if (pbl_build(pblimg, rcw->data, rcw->len, bl2->data, bl2->len,
+		      &out) != SUCCESS)
+		return FAILURE;
+
+	if (pblimg->bootptr)
+		printf("\nBoot Location Pointer= %x\n", pblimg->ep);
+
+	fp_rcw_pbi_op = fopen(pblimg->imagefile, "wb");
 	if (fp_rcw_pbi_op == NULL) {
-		printf("%s: Error opening the input file: %s\n",
-			__func__, pblimg.imagefile);
-		goto exit_main;
+		printf("%s: Error opening the output file: %s\n",
+			__func__, pblimg->imagefile);
+		goto create_err;
 	}
 
-	printf("\nInput Boot Source: %s\n", boot_src_string[pblimg.boot_src]);
-	printf("Input RCW File: %s\n", pblimg.rcw_nm);
-	printf("Input BL2 Binary File: %s\n", pblimg.sec_imgnm);
-	printf("Input load address for BL2 Binary File: 0x%x\n", pblimg.addr);
-
-    printf("Chassis Type: %d\n", pblimg.chassis);
-    switch (pblimg.chassis) {
-        case CHASSIS_2 :
-    		if (fread(&word, sizeof(word), NUM_MEM_BLOCK, fp_rcw_pbi_ip)
-    			!= NUM_MEM_BLOCK) {
-    			printf("%s: Error in reading word from the rcw file.\n",
-    				__func__);
-    			goto exit_main;
-    		}
-		while (BYTE_SWAP_32(word) != 0x08610040) {
-			if (BYTE_SWAP_32(word) == 0x09550000
-			    || BYTE_SWAP_32(word) == 0x000f400c) {
-				break;
-			}
-			if (fwrite(&word, sizeof(word), NUM_MEM_BLOCK,
-			    fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-				printf("%s: [CH2] Error in Writing PBI Words\n",
-						__func__);
-				goto exit_main;
-			}
-			if (fread(&word, sizeof(word), NUM_MEM_BLOCK,
-			    fp_rcw_pbi_ip) != NUM_MEM_BLOCK) {
-				printf("%s: [CH2] Error in Reading PBI Words\n",
-						__func__);
-				goto exit_main;
-			}
-		}
+	if (fwrite(out.data, 1, out.len, fp_rcw_pbi_op) == out.len)
+		ret = SUCCESS;
+	if (fclose(fp_rcw_pbi_op) != 0)
+		ret = FAILURE;
+	if (ret != SUCCESS) {
+		printf("%s: Error in writing the output file: %s\n",
+			__func__, pblimg->imagefile);
+		goto create_err;
+	}
+
+	printf("Output file successfully created with name: %s\n\n",
+		   pblimg->imagefile);
 
-		if (bootptr_flag == true) {
-    			/* Add command to set boot_loc ptr */
-    			ret = add_boot_ptr_cmd(fp_rcw_pbi_op);
-    			if (ret != SUCCESS) {
-    				goto exit_main;
-    			}
+create_err:
+	pbl_buf_free(&out);
+	return ret;
+}
+
+/***************************************************************************
+ * Function	:	run_batch
+ * Arguments	:	defaults - options of the command line
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	Generate the image described by each line of the
+ *			batch file. Options are separated by blanks, empty
+ *			lines and lines starting with '#' are skipped.
+ ***************************************************************************/
+static int run_batch(const struct pbl_job *defaults)
+{
+	char line[MAX_BATCH_LINE];
+	char *argv[MAX_BATCH_ARGS + 1];
+	struct pbl_job job;
+	int argc, line_num = 0, num = 0;
+	int ret = SUCCESS;
+	FILE *fp;
+
+	fp = fopen(defaults->batch_nm, "r");
+	if (fp == NULL) {
+		printf("%s: Error in opening the batch file: %s\n",
+			__func__, defaults->batch_nm);
+		return FAILURE;
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		line_num++;
+
+		argc = 0;
+		argv[argc++] = "create_pbl";
+		for (argv[argc] = strtok(line, " \t\r\n");
+		     (argv[argc] != NULL) && (argc < MAX_BATCH_ARGS);
+		     argv[argc] = strtok(NULL, " \t\r\n"))
+			argc++;
+		argv[argc] = NULL;
+
+		if ((argc == 1) || (argv[1][0] == '#'))
+			continue;
+
+		job = *defaults;
+		job.batch_nm = NULL;
+		if (parse_args(argc, argv, &job) != SUCCESS) {
+			ret = FAILURE;
+			break;
+		}
+		if (job.batch_nm != NULL) {
+			printf("%s:%d: Batch files cannot be nested.\n",
+				defaults->batch_nm, line_num);
+			ret = FAILURE;
+			break;
+		}
+		if ((job.args & MAND_ARG_MASK) != MAND_ARG_MASK) {
+			printf("%s:%d: Missing mandatory options.\n",
+				defaults->batch_nm, line_num);
+			ret = FAILURE;
+			break;
 		}
 
-    		/* Write acs write commands to output file */
-    		ret = add_cpy_cmd(fp_rcw_pbi_op);
-    		if (ret != SUCCESS) {
-    			goto exit_main;
-    		}
-
-		    /*
-		     * Add stop command after adding pbi commands
-		     * For Chasis 2.0 platforms it is always CRC &
-		     * Stop command
-		     */
-		flag_stop_cmd = CRC_STOP_COMMAND;
-	        ret = add_pbi_stop_cmd(fp_rcw_pbi_op, flag_stop_cmd);
-    		if (ret != SUCCESS) {
-    			goto exit_main;
-    		}
-
-            break;
-
-        case CHASSIS_3   :
-        case CHASSIS_3_2 :
-    		if (fread(&word, sizeof(word), NUM_MEM_BLOCK, fp_rcw_pbi_ip)
-    			!= NUM_MEM_BLOCK) {
-    			printf("%s: Error reading PBI Cmd.\n", __func__);
-    			goto exit_main;
-    		}
-    		while (word != 0x808f0000 && word != 0x80ff0000) {
-    			pbl_size++;
-			/* 11th words in RCW has PBL length. Update it
-			 * with new length. 2 comamnds get added 
-			 * Block copy + CCSR Write/CSF header write 
-			 */	
-    			if (pbl_size == 11) {
-    				word_1 = (word & PBI_LEN_MASK)
-    					+ (PBI_LEN_ADD << 20);
-    				word = word & ~PBI_LEN_MASK;
-    				word = word | word_1;
-    			}
-			/* Update the CRC command */
-			/* RUCHIKA TBD -- Check load command..add a check if command is Stop with CRC or stop without checksum */
-    			if (pbl_size == 35) {
-    				word = crypto_calculate_checksum(fp_rcw_pbi_op,
-    						NUM_RCW_WORD - 1);
-    				if (word == FAILURE) {
-    					goto exit_main;
-    				}
-    			}
-    			if (fwrite(&word, sizeof(word),	NUM_MEM_BLOCK,
-    				fp_rcw_pbi_op) != NUM_MEM_BLOCK) {
-    				printf("%s: [CH3] Error in Writing PBI Words\n",
-    					__func__);
-    				goto exit_main;
-    			}
-    			if (fread(&word, sizeof(word), NUM_MEM_BLOCK,
-    				fp_rcw_pbi_ip) != NUM_MEM_BLOCK) {
-    				printf("%s: [CH3] Error in Reading PBI Words\n",
-    					 __func__);
-    				goto exit_main;
-    			}
-
-			if (word == CRC_STOP_CMD_ARM_CH3) {
-				flag_stop_cmd = CRC_STOP_COMMAND;
-			} else if (word == STOP_CMD_ARM_CH3){
-				flag_stop_cmd = STOP_COMMAND;
-			}
-    		}
-		if (bootptr_flag == true) {
-    			/* Add command to set boot_loc ptr */
-    			ret = add_boot_ptr_cmd(fp_rcw_pbi_op);
-    			if (ret != SUCCESS) {
-    				printf("%s: Function get_boot_ptr return failure.\n",
-    					__func__);
-    				goto exit_main;
-    			}
+		/*
+		 * The options point into the line, but they are no longer
+		 * needed once the image is written.
+		 */
+		if (create_pbl(&job) != SUCCESS) {
+			printf("%s:%d: Error in creating the image.\n",
+				defaults->batch_nm, line_num);
+			ret = FAILURE;
+			break;
 		}
+		num++;
+	}
+
+	fclose(fp);
+
+	if (ret == SUCCESS)
+		printf("%d PBL images created from %s\n", num,
+			defaults->batch_nm);
+
+	return ret;
+}
 
-    		/* Write acs write commands to output file */
-    		ret = add_blk_cpy_cmd(fp_rcw_pbi_op, args);
-    		if (ret != SUCCESS) {
-    			printf("%s: Function add_blk_cpy_cmd return failure.\n",
-    				 __func__);
-    			goto exit_main;
-    		}
+int main(int argc, char **argv)
+{
+	struct pbl_job job;
+	int ret = FAILURE;
+
+	/* Initializing the global structure to zero. */
+	memset(&job, 0x0, sizeof(job));
+	job.args = ARG_INIT_MASK;
 
-		/* Add stop command after adding pbi commands */
-	        ret = add_pbi_stop_cmd(fp_rcw_pbi_op, flag_stop_cmd);
-    		if (ret != SUCCESS) {
-    			goto exit_main;
-    		}
+	if (parse_args(argc, argv, &job) != SUCCESS)
+		goto exit_main;
 
-            break;
+	if (job.batch_nm != NULL) {
+		ret = run_batch(&job);
+		goto exit_main;
+	}
 
-        default :
-    		printf("%s: Unknown chassis type.\n",
-    				__func__);
-    }
+	if ((job.args & MAND_ARG_MASK) != MAND_ARG_MASK)
+		print_usage();
 
-	if (ret == SUCCESS)
-		printf("Output file successfully created with name: %s\n\n",
-			   pblimg.imagefile);
+	ret = create_pbl(&job);
 
 exit_main:
-	if (fp_rcw_pbi_op != NULL)
-		fclose(fp_rcw_pbi_op);
-	if (fp_rcw_pbi_ip != NULL)
-		fclose(fp_rcw_pbi_ip);
+	free_files();
 
 	return ret;
 }
@@ -0,0 +1,756 @@
+/*
+ * Copyright 2018 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Author  Vinitha V Pillai <vinitha.pillai@nxp.com>
+ *         Pankaj Gupta <pankaj.gupta@nxp.com>
+ */
+
+/*
+ * PBL image builder.
+ *
+ * The RCW, the PBI commands and the BL2 copy commands are assembled in a
+ * memory buffer which the caller writes out in one go. Words are stored in
+ * host byte order, as the tool has always written them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pbl_builder.h"
+
+/* Define for add_boot_ptr_cmd() */
+#define BOOTPTR_ADDR 0x09570604
+#define CSF_ADDR_SB 0x09ee0200
+/* CCSR write command to address 0x1e00400 i.e BOOTLOCPTR */
+#define BOOTPTR_ADDR_CH3 0x31e00400
+/* Load CSF header command */
+#define CSF_ADDR_SB_CH3 0x80220000
+
+/* Define for add_cpy_cmd() */
+#define OFFSET_MASK		        0x00ffffff
+#define WRITE_CMD_BASE		    0x81000000
+#define MAX_PBI_DATA_LEN_BYTE	64
+
+/* 140 Bytes = Preamble + LOAD RCW command + RCW (128 bytes) + Checksum */
+#define CHS3_CRC_PAYLOAD_START_OFFSET 140
+
+#define PBI_CRC_POLYNOMIAL	0x04c11db7
+#define CRC32_POLYNOMIAL	0xedb88320
+
+#define CRC_STOP_CMD_ARM	0x08610040
+#define CRC_STOP_CMD_ARM_CH3	0x808f0000
+#define STOP_CMD_ARM_CH3	0x80ff0000
+#define BYTE_SWAP_32(word)	((((word) & 0xff000000) >> 24)|	\
+				(((word) & 0x00ff0000) >>  8) |	\
+				(((word) & 0x0000ff00) <<  8) |	\
+				(((word) & 0x000000ff) << 24))
+
+#define PBI_LEN_MASK	0xFFF00000
+#define PBI_LEN_SHIFT	20
+#define NUM_RCW_WORD	35
+#define PBI_LEN_ADD		6
+
+#define MAX_CRC_ENTRIES 256
+/* Number of bytes consumed per step of the CRC loops */
+#define CRC_SLICES	8
+
+/* SoC numeric identifier */
+#define SOC_LS1012 1012
+#define SOC_LS1023 1023
+#define SOC_LS1026 1026
+#define SOC_LS1028 1028
+#define SOC_LS1043 1043
+#define SOC_LS1046 1046
+#define SOC_LS1088 1088
+#define SOC_LS2080 2080
+#define SOC_LS2088 2088
+#define SOC_LX2160 2160
+
+/* Base Addresses where PBL image is copied depending on the boot source.
+ * Boot address map varies as per Chassis architecture.
+ */
+#define BASE_ADDR_UNDEFINED  0xFFFFFFFF
+#define BASE_ADDR_QSPI       0x20000000
+#define BASE_ADDR_SD         0x00001000
+#define BASE_ADDR_IFC_NOR    0x30000000
+#define BASE_ADDR_EMMC       0x00001000
+#define BASE_ADDR_FLX_NOR    0x20000000
+#define BASE_ADDR_NAND       0x20000000
+
+static const uint32_t base_addr_ch3[MAX_BOOT] = {
+    BASE_ADDR_UNDEFINED,
+    BASE_ADDR_IFC_NOR,
+    BASE_ADDR_UNDEFINED,	/*IFC NAND */
+    BASE_ADDR_QSPI,
+    BASE_ADDR_SD,
+    BASE_ADDR_EMMC,
+    BASE_ADDR_UNDEFINED,	/*FLXSPI NOR */
+    BASE_ADDR_UNDEFINED,	/*FLXSPI NAND 2K */
+    BASE_ADDR_UNDEFINED		/*FLXSPI NAND 4K */
+};
+
+static const uint32_t base_addr_ch32[MAX_BOOT] = {
+    BASE_ADDR_UNDEFINED,
+    BASE_ADDR_UNDEFINED,	/* IFC NOR */
+    BASE_ADDR_UNDEFINED,	/* IFC NAND */
+    BASE_ADDR_UNDEFINED,	/* QSPI */
+    BASE_ADDR_SD,
+    BASE_ADDR_EMMC,
+    BASE_ADDR_FLX_NOR,
+    BASE_ADDR_UNDEFINED,	/*FLXSPI NAND 2K */
+    BASE_ADDR_UNDEFINED		/*FLXSPI NAND 4K */
+};
+
+/* for Chassis 3 */
+static const uint32_t blk_cpy_hdr_map_ch3[MAX_BOOT] = {
+
+	0,		    /* Unknown Boot Source */
+	0x80000020,	/* NOR_BOOT */
+	0x0,		/* NAND_BOOT */
+	0x80000062,	/* QSPI_BOOT */
+	0x80000040,	/* SD_BOOT */
+	0x80000041,	/* EMMC_BOOT */
+	0x0,		/* FLEXSPI NOR_BOOT */
+	0x0,	/* FLEX SPI NAND2K BOOT */
+	0x0,	/* CHASIS3_2_NAND4K_BOOT */
+};
+
+static const uint32_t blk_cpy_hdr_map_ch32[MAX_BOOT] = {
+	0,		    /* Unknown Boot Source */
+	0x0,		/* NOR_BOOT */
+	0x0,		/* NAND_BOOT */
+	0x0,		/* QSPI_BOOT */
+	0x80000008,	/* SD_BOOT */
+	0x80000009,	/* EMMC_BOOT */
+	0x8000000F,	/* FLEXSPI NOR_BOOT */
+	0x8000000C,	/* FLEX SPI NAND2K BOOT */
+	0x8000000D,	/* CHASIS3_2_NAND4K_BOOT */
+};
+
+static const char *boot_src_string[MAX_BOOT] = {
+	"UNKNOWN_BOOT",
+	"IFC_NOR_BOOT",
+	"IFC_NAND_BOOT",
+	"QSPI_BOOT",
+	"SD_BOOT",
+	"EMMC_BOOT",
+	"FLXSPI_NOR_BOOT",
+	"FLXSPI_NAND_BOOT",
+	"FLXSPI_NAND4K_BOOT",
+};
+
+/* Boot source names accepted on the command line */
+static const struct {
+	const char *name;
+	boot_src_t boot_src;
+} boot_src_names[] = {
+	{ "qspi",		QSPI_BOOT },
+	{ "nor",		IFC_NOR_BOOT },
+	{ "nand",		IFC_NAND_BOOT },
+	{ "sd",			SD_BOOT },
+	{ "emmc",		EMMC_BOOT },
+	{ "flexspi_nor",	FLXSPI_NOR_BOOT },
+	{ "flexspi_nand",	FLXSPI_NAND_BOOT },
+	{ "flexspi_nand2k",	FLXSPI_NAND4K_BOOT },
+};
+
+enum stop_command {
+	STOP_COMMAND = 0,
+	CRC_STOP_COMMAND
+};
+
+/***************************************************************************
+ * Description	:	Slicing-by-8 CRC32 Lookup Tables.
+ *			crc32_lookup[0] is the byte-wise table, entry [k][i]
+ *			is the CRC of byte i followed by k zero bytes.
+ ***************************************************************************/
+static uint32_t crc32_lookup[CRC_SLICES][MAX_CRC_ENTRIES];	/* Reflected */
+static uint32_t crc32_msb_lookup[CRC_SLICES][MAX_CRC_ENTRIES];	/* MSB first */
+static bool crc_tables_done;
+
+static void crc_init_tables(void)
+{
+	uint32_t i, j, c;
+
+	if (crc_tables_done)
+		return;
+
+	for (i = 0; i < MAX_CRC_ENTRIES; i++) {
+		c = i;
+		for (j = 0; j < 8; j++)
+			c = c & 1 ? CRC32_POLYNOMIAL ^ (c >> 1) : c >> 1;
+		crc32_lookup[0][i] = c;
+
+		c = i << 24;
+		for (j = 0; j < 8; j++)
+			c = c & 0x80000000 ?
+			PBI_CRC_POLYNOMIAL ^ (c << 1) : c << 1;
+		crc32_msb_lookup[0][i] = c;
+	}
+
+	for (j = 1; j < CRC_SLICES; j++) {
+		for (i = 0; i < MAX_CRC_ENTRIES; i++) {
+			c = crc32_lookup[j - 1][i];
+			crc32_lookup[j][i] = (c >> 8) ^
+					     crc32_lookup[0][c & 0xff];
+			c = crc32_msb_lookup[j - 1][i];
+			crc32_msb_lookup[j][i] = (c << 8) ^
+						 crc32_msb_lookup[0][c >> 24];
+		}
+	}
+
+	crc_tables_done = true;
+}
+
+/***************************************************************************
+ * Function	:	pbl_crc32
+ * Arguments	:	crc - CRC so far
+ *			buf - data, len - length of data in bytes
+ * Return	:	Updated CRC
+ * Description	:	Reflected CRC32 (Chassis 3), 8 bytes per step.
+ ***************************************************************************/
+uint32_t pbl_crc32(uint32_t crc, const uint8_t *buf, size_t len)
+{
+	uint32_t one, two;
+
+	crc_init_tables();
+
+	while (len >= CRC_SLICES) {
+		one = crc ^ ((uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+			     ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));
+		two = (uint32_t)buf[4] | ((uint32_t)buf[5] << 8) |
+		      ((uint32_t)buf[6] << 16) | ((uint32_t)buf[7] << 24);
+		crc = crc32_lookup[7][one & 0xff] ^
+		      crc32_lookup[6][(one >> 8) & 0xff] ^
+		      crc32_lookup[5][(one >> 16) & 0xff] ^
+		      crc32_lookup[4][one >> 24] ^
+		      crc32_lookup[3][two & 0xff] ^
+		      crc32_lookup[2][(two >> 8) & 0xff] ^
+		      crc32_lookup[1][(two >> 16) & 0xff] ^
+		      crc32_lookup[0][two >> 24];
+		buf += CRC_SLICES;
+		len -= CRC_SLICES;
+	}
+
+	while (len--)
+		crc = (crc >> 8) ^ crc32_lookup[0][(crc ^ *buf++) & 0xff];
+
+	return crc;
+}
+
+/***************************************************************************
+ * Function	:	pbl_crc32_msb
+ * Arguments	:	crc - CRC so far
+ *			buf - data, len - length of data in bytes
+ * Return	:	Updated CRC
+ * Description	:	MSB first CRC32 (Chassis 2), 8 bytes per step.
+ ***************************************************************************/
+uint32_t pbl_crc32_msb(uint32_t crc, const uint8_t *buf, size_t len)
+{
+	uint32_t one, two;
+
+	crc_init_tables();
+
+	while (len >= CRC_SLICES) {
+		one = crc ^ (((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+			     ((uint32_t)buf[2] << 8) | (uint32_t)buf[3]);
+		two = ((uint32_t)buf[4] << 24) | ((uint32_t)buf[5] << 16) |
+		      ((uint32_t)buf[6] << 8) | (uint32_t)buf[7];
+		crc = crc32_msb_lookup[7][one >> 24] ^
+		      crc32_msb_lookup[6][(one >> 16) & 0xff] ^
+		      crc32_msb_lookup[5][(one >> 8) & 0xff] ^
+		      crc32_msb_lookup[4][one & 0xff] ^
+		      crc32_msb_lookup[3][two >> 24] ^
+		      crc32_msb_lookup[2][(two >> 16) & 0xff] ^
+		      crc32_msb_lookup[1][(two >> 8) & 0xff] ^
+		      crc32_msb_lookup[0][two & 0xff];
+		buf += CRC_SLICES;
+		len -= CRC_SLICES;
+	}
+
+	while (len--)
+		crc = crc32_msb_lookup[0][((crc >> 24) ^ *buf++) & 0xff] ^
+		      (crc << 8);
+
+	return crc;
+}
+
+/* Returns the chassis of a SoC numeric identifier */
+chassis_t pbl_soc_chassis(int soc)
+{
+	switch (soc) {
+	case SOC_LS1012:
+	case SOC_LS1023:
+	case SOC_LS1026:
+	case SOC_LS1043:
+	case SOC_LS1046:
+		return CHASSIS_2;
+	case SOC_LS1088:
+	case SOC_LS2080:
+	case SOC_LS2088:
+		return CHASSIS_3;
+	case SOC_LS1028:
+	case SOC_LX2160:
+		return CHASSIS_3_2;
+	default:
+		return CHASSIS_UNKNOWN;
+	}
+}
+
+/* Returns the boot source matching a command line name */
+boot_src_t pbl_boot_src(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(boot_src_names) / sizeof(boot_src_names[0]);
+	     i++) {
+		if (!strcmp(name, boot_src_names[i].name))
+			return boot_src_names[i].boot_src;
+	}
+
+	return UNKNOWN_BOOT;
+}
+
+const char *pbl_boot_src_string(boot_src_t boot_src)
+{
+	if (boot_src >= MAX_BOOT)
+		boot_src = UNKNOWN_BOOT;
+
+	return boot_src_string[boot_src];
+}
+
+/* Make room for len more bytes in the buffer */
+static int buf_reserve(struct pbl_buf *buf, size_t len)
+{
+	size_t size = buf->size ? buf->size : 4096;
+	uint8_t *data;
+
+	if (buf->len + len <= buf->size)
+		return SUCCESS;
+
+	while (size < buf->len + len)
+		size *= 2;
+
+	data = realloc(buf->data, size);
+	if (data == NULL) {
+		printf("%s: Out of memory.\n", __func__);
+		return FAILURE;
+	}
+
+	buf->data = data;
+	buf->size = size;
+
+	return SUCCESS;
+}
+
+static int buf_put(struct pbl_buf *buf, const void *data, size_t len)
+{
+	if (len == 0)
+		return SUCCESS;
+
+	if (buf_reserve(buf, len) != SUCCESS)
+		return FAILURE;
+
+	memcpy(buf->data + buf->len, data, len);
+	buf->len += len;
+
+	return SUCCESS;
+}
+
+static int buf_put_word(struct pbl_buf *buf, uint32_t word)
+{
+	return buf_put(buf, &word, sizeof(word));
+}
+
+static uint32_t buf_get_word(const uint8_t *data, size_t idx)
+{
+	uint32_t word;
+
+	memcpy(&word, data + idx * sizeof(word), sizeof(word));
+
+	return word;
+}
+
+void pbl_buf_free(struct pbl_buf *buf)
+{
+	free(buf->data);
+	buf->data = NULL;
+	buf->len = 0;
+	buf->size = 0;
+}
+
+/***************************************************************************
+ * Function	:	calculate_checksum()
+ * Arguments	:	data - output image
+ *			num - Number of 32 bit words for checksum
+ * Return	:	Checksum Value
+ * Description	:	Calculate Checksum over the data
+ ***************************************************************************/
+static uint32_t calculate_checksum(const uint8_t *data, uint32_t num)
+{
+	uint32_t i;
+	uint32_t sum = 0;
+
+	for (i = 0; i < num; i++)
+		sum += buf_get_word(data, i);
+
+	return sum;
+}
+
+/***************************************************************************
+ * Function	:	add_pbi_stop_cmd
+ * Arguments	:	img - image parameters, out - output image
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	This function insert pbi stop command.
+ ***************************************************************************/
+static int add_pbi_stop_cmd(const struct pbl_image *img, struct pbl_buf *out,
+			    enum stop_command flag)
+{
+	uint32_t pbi_stop_cmd;
+	uint32_t pbi_crc = 0xffffffff;
+
+	switch (img->chassis) {
+	case CHASSIS_2:
+		pbi_stop_cmd = BYTE_SWAP_32(CRC_STOP_CMD_ARM);
+		break;
+	case CHASSIS_3:
+	case CHASSIS_3_2:
+		/*Based on flag add the corresponsding cmd -- stop cmd or stop with CRC cmd */
+		if (flag == CRC_STOP_COMMAND){
+			pbi_stop_cmd = CRC_STOP_CMD_ARM_CH3;
+		} else {
+			pbi_stop_cmd = STOP_CMD_ARM_CH3;
+		}
+		break;
+	default:
+		printf("Internal Error: Invalid Chassis val = %d.\n",
+			img->chassis);
+		return FAILURE;
+	}
+
+	if (buf_put_word(out, pbi_stop_cmd) != SUCCESS) {
+		printf("%s: Error in Writing PBI STOP CMD\n", __func__);
+		return FAILURE;
+	}
+
+	if (img->chassis == CHASSIS_2) {
+		/* Chassis 2: CRC is calculated on  RCW + PBL cmd.*/
+		pbi_crc = pbl_crc32_msb(pbi_crc, out->data, out->len);
+		pbi_crc = BYTE_SWAP_32(pbi_crc);
+	} else if (flag == CRC_STOP_COMMAND) {
+		/* Chassis 3: CRC is calculated on  PBL cmd only. */
+		if (out->len > CHS3_CRC_PAYLOAD_START_OFFSET)
+			pbi_crc = pbl_crc32(pbi_crc,
+				out->data + CHS3_CRC_PAYLOAD_START_OFFSET,
+				out->len - CHS3_CRC_PAYLOAD_START_OFFSET);
+		pbi_crc = pbi_crc ^ 0xFFFFFFFF;
+	} else {
+		pbi_crc = 0x00000000;
+	}
+
+	if (buf_put_word(out, pbi_crc) != SUCCESS) {
+		printf("%s: Error in Writing PBI PBI CRC\n", __func__);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/***************************************************************************
+ * Function	:	add_boot_ptr_cmd
+ * Arguments	:	img - image parameters, out - output image
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	Add bootptr pbi command to output image
+ ***************************************************************************/
+static int add_boot_ptr_cmd(const struct pbl_image *img, struct pbl_buf *out)
+{
+	uint32_t bootptr_addr;
+	uint32_t ep = img->ep;
+
+	switch (img->chassis) {
+	case CHASSIS_2:
+		if (img->sb)
+			bootptr_addr = BYTE_SWAP_32(CSF_ADDR_SB);
+		else
+			bootptr_addr = BYTE_SWAP_32(BOOTPTR_ADDR);
+		ep = BYTE_SWAP_32(ep);
+		break;
+	case CHASSIS_3:
+	case CHASSIS_3_2:
+		if (img->sb)
+			bootptr_addr = CSF_ADDR_SB_CH3;
+		else
+			bootptr_addr = BOOTPTR_ADDR_CH3;
+		break;
+	default:
+		printf("Internal Error: Invalid Chassis val = %d.\n",
+			img->chassis);
+		return FAILURE;
+	}
+
+	if (buf_put_word(out, bootptr_addr) != SUCCESS)
+		return FAILURE;
+
+	if ((ep != 0) && (buf_put_word(out, ep) != SUCCESS))
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/***************************************************************************
+ * Function	:	add_blk_cpy_cmd
+ * Arguments	:	img - image parameters, out - output image
+ *			bl2_len - size of the BL2 image
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	Add pbi commands for block copy cmd
+ ***************************************************************************/
+static int add_blk_cpy_cmd(const struct pbl_image *img, struct pbl_buf *out,
+			   size_t bl2_len)
+{
+	uint32_t blk_cpy_hdr, src_addr;
+	uint32_t file_size, new_file_size;
+	uint32_t align = 4;
+
+	if (!img->src_addr_valid) {
+		printf("ERROR: Offset not specified for Block Copy Cmd. \
+			See Usage and use -f option\n");
+		return FAILURE;
+	}
+
+	switch (img->chassis) {
+        case CHASSIS_3 :
+		/* Block copy command */
+		blk_cpy_hdr = blk_cpy_hdr_map_ch3[img->boot_src];
+		src_addr = img->src_addr + base_addr_ch3[img->boot_src];
+		break;
+        case CHASSIS_3_2 :
+		/* Block copy command */
+		blk_cpy_hdr = blk_cpy_hdr_map_ch32[img->boot_src];
+		src_addr = img->src_addr + base_addr_ch32[img->boot_src];
+		break;
+        default :
+		printf("%s: Error invalid chassis type for this command.\n",
+				__func__);
+		return FAILURE;
+	}
+
+	file_size = bl2_len;
+	if (file_size > 0) {
+		new_file_size = (file_size+(file_size % align));
+
+		/* Block copy command, Src, Dest address words and size */
+		if ((buf_put_word(out, blk_cpy_hdr) != SUCCESS) ||
+		    (buf_put_word(out, src_addr) != SUCCESS) ||
+		    (buf_put_word(out, img->addr) != SUCCESS) ||
+		    (buf_put_word(out, new_file_size) != SUCCESS)) {
+			printf("%s: Error writing block copy command.\n",
+				 __func__);
+			return FAILURE;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/***************************************************************************
+ * Function	:	add_cpy_cmd
+ * Arguments	:	img - image parameters, out - output image
+ *			bl2, bl2_len - BL2 image
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	Append pbi commands for copying BL2 image to the
+ *			load address stored in img->addr
+ ***************************************************************************/
+static int add_cpy_cmd(const struct pbl_image *img, struct pbl_buf *out,
+		       const uint8_t *bl2, size_t bl2_len)
+{
+	uint32_t ALTCBAR_ADDRESS = BYTE_SWAP_32(0x09570158);
+	uint32_t WAIT_CMD_WRITE_ADDRESS = BYTE_SWAP_32(0x096100c0);
+	uint32_t WAIT_CMD = BYTE_SWAP_32(0x000FFFFF);
+	uint32_t pbi_cmd, altcbar;
+	uint32_t dst_offset;
+	size_t offset, chunk, num_chunks;
+	uint8_t *pbi_data;
+
+	altcbar = img->addr;
+	dst_offset = img->addr;
+	altcbar = 0xfff00000 & altcbar;
+	altcbar = BYTE_SWAP_32(altcbar >> 16);
+
+	if ((buf_put_word(out, ALTCBAR_ADDRESS) != SUCCESS) ||
+	    (buf_put_word(out, altcbar) != SUCCESS) ||
+	    (buf_put_word(out, WAIT_CMD_WRITE_ADDRESS) != SUCCESS) ||
+	    (buf_put_word(out, WAIT_CMD) != SUCCESS)) {
+		printf("%s: Error in writing ALTCFG/WAIT CMD.\n", __func__);
+		return FAILURE;
+	}
+
+	/*
+	 * The image is copied in 64 bytes write commands, the last one being
+	 * zero padded. An image of a multiple of 64 bytes is followed by a
+	 * write command of zeros, as the tool has always done.
+	 */
+	num_chunks = bl2_len / MAX_PBI_DATA_LEN_BYTE + 1;
+	if (buf_reserve(out, num_chunks *
+			(sizeof(pbi_cmd) + MAX_PBI_DATA_LEN_BYTE)) != SUCCESS)
+		return FAILURE;
+
+	for (offset = 0; offset < num_chunks * MAX_PBI_DATA_LEN_BYTE;
+	     offset += MAX_PBI_DATA_LEN_BYTE) {
+		dst_offset &= OFFSET_MASK;
+		pbi_cmd = WRITE_CMD_BASE | dst_offset;
+		pbi_cmd = BYTE_SWAP_32(pbi_cmd);
+		buf_put_word(out, pbi_cmd);
+
+		pbi_data = out->data + out->len;
+		chunk = offset < bl2_len ? bl2_len - offset : 0;
+		if (chunk > MAX_PBI_DATA_LEN_BYTE)
+			chunk = MAX_PBI_DATA_LEN_BYTE;
+		memcpy(pbi_data, bl2 + offset, chunk);
+		memset(pbi_data + chunk, 0, MAX_PBI_DATA_LEN_BYTE - chunk);
+		out->len += MAX_PBI_DATA_LEN_BYTE;
+
+		dst_offset += MAX_PBI_DATA_LEN_BYTE;
+	}
+
+	return SUCCESS;
+}
+
+/* Chassis 2: RCW + PBI commands up to the CRC and Stop command */
+static int build_ch2(const struct pbl_image *img, const uint8_t *rcw,
+		     size_t rcw_len, const uint8_t *bl2, size_t bl2_len,
+		     struct pbl_buf *out)
+{
+	size_t num_words = rcw_len / sizeof(uint32_t);
+	uint32_t word;
+	size_t i;
+
+	for (i = 0; ; i++) {
+		if (i == num_words) {
+			printf("%s: [CH2] Error in Reading PBI Words\n",
+					__func__);
+			return FAILURE;
+		}
+		word = buf_get_word(rcw, i);
+		if (BYTE_SWAP_32(word) == 0x08610040
+		    || BYTE_SWAP_32(word) == 0x09550000
+		    || BYTE_SWAP_32(word) == 0x000f400c)
+			break;
+	}
+
+	if (buf_put(out, rcw, i * sizeof(word)) != SUCCESS)
+		return FAILURE;
+
+	/* Add command to set boot_loc ptr */
+	if (img->bootptr && (add_boot_ptr_cmd(img, out) != SUCCESS))
+		return FAILURE;
+
+	/* Write acs write commands to output image */
+	if (add_cpy_cmd(img, out, bl2, bl2_len) != SUCCESS)
+		return FAILURE;
+
+	/*
+	 * Add stop command after adding pbi commands
+	 * For Chasis 2.0 platforms it is always CRC &
+	 * Stop command
+	 */
+	return add_pbi_stop_cmd(img, out, CRC_STOP_COMMAND);
+}
+
+/* Chassis 3: RCW + PBI commands up to the Stop command */
+static int build_ch3(const struct pbl_image *img, const uint8_t *rcw,
+		     size_t rcw_len, size_t bl2_len, struct pbl_buf *out)
+{
+	size_t num_words = rcw_len / sizeof(uint32_t);
+	enum stop_command flag_stop_cmd = CRC_STOP_COMMAND;
+	uint32_t word, word_1;
+	size_t pbl_size;
+
+	if (buf_reserve(out, rcw_len) != SUCCESS)
+		return FAILURE;
+
+	for (pbl_size = 0; ; pbl_size++) {
+		if (pbl_size == num_words) {
+			printf("%s: [CH3] Error in Reading PBI Words\n",
+				 __func__);
+			return FAILURE;
+		}
+		word = buf_get_word(rcw, pbl_size);
+		if (word == CRC_STOP_CMD_ARM_CH3 || word == STOP_CMD_ARM_CH3)
+			break;
+
+		/* 11th words in RCW has PBL length. Update it
+		 * with new length. 2 comamnds get added
+		 * Block copy + CCSR Write/CSF header write
+		 */
+		if (pbl_size + 1 == 11) {
+			word_1 = (word & PBI_LEN_MASK)
+				+ (PBI_LEN_ADD << 20);
+			word = word & ~PBI_LEN_MASK;
+			word = word | word_1;
+		}
+		/* Update the CRC command */
+		if (pbl_size + 1 == NUM_RCW_WORD)
+			word = calculate_checksum(out->data, NUM_RCW_WORD - 1);
+
+		buf_put_word(out, word);
+	}
+
+	if ((pbl_size != 0) && (word == STOP_CMD_ARM_CH3))
+		flag_stop_cmd = STOP_COMMAND;
+
+	/* Add command to set boot_loc ptr */
+	if (img->bootptr && (add_boot_ptr_cmd(img, out) != SUCCESS)) {
+		printf("%s: Function get_boot_ptr return failure.\n",
+			__func__);
+		return FAILURE;
+	}
+
+	/* Write acs write commands to output image */
+	if (add_blk_cpy_cmd(img, out, bl2_len) != SUCCESS) {
+		printf("%s: Function add_blk_cpy_cmd return failure.\n",
+			 __func__);
+		return FAILURE;
+	}
+
+	/* Add stop command after adding pbi commands */
+	return add_pbi_stop_cmd(img, out, flag_stop_cmd);
+}
+
+/***************************************************************************
+ * Function	:	pbl_build
+ * Arguments	:	img - image parameters
+ *			rcw, rcw_len - input RCW image
+ *			bl2, bl2_len - input BL2 image
+ *			out - output image, reset on entry
+ * Return	:	SUCCESS or FAILURE
+ * Description	:	Build the PBL image in memory. On failure, out is
+ *			freed.
+ ***************************************************************************/
+int pbl_build(const struct pbl_image *img, const uint8_t *rcw, size_t rcw_len,
+	      const uint8_t *bl2, size_t bl2_len, struct pbl_buf *out)
+{
+	int ret;
+
+	out->len = 0;
+
+	switch (img->chassis) {
+	case CHASSIS_2:
+		ret = build_ch2(img, rcw, rcw_len, bl2, bl2_len, out);
+		break;
+	case CHASSIS_3:
+	case CHASSIS_3_2:
+		ret = build_ch3(img, rcw, rcw_len, bl2_len, out);
+		break;
+	default:
+		printf("%s: Unknown chassis type.\n", __func__);
+		ret = FAILURE;
+	}
+
+	if (ret != SUCCESS)
+		pbl_buf_free(out);
+
+	return ret;
+}
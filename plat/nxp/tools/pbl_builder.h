@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PBL_BUILDER_H__
+#define __PBL_BUILDER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SUCCESS			 0
+#define FAILURE			-1
+
+typedef enum {
+	CHASSIS_UNKNOWN,
+	CHASSIS_2,
+	CHASSIS_3,
+	CHASSIS_3_2,
+	CHASSIS_MAX    /* must be last item in list */
+} chassis_t;
+
+typedef enum {
+	UNKNOWN_BOOT = 0,
+	IFC_NOR_BOOT,
+	IFC_NAND_BOOT,
+	QSPI_BOOT,
+	SD_BOOT,
+	EMMC_BOOT,
+	FLXSPI_NOR_BOOT,
+	FLXSPI_NAND_BOOT,
+	FLXSPI_NAND4K_BOOT,
+	MAX_BOOT    /* must be last item in list */
+} boot_src_t;
+
+/* Structure will get populated in the main function
+ * as part of parsing the command line arguments.
+ * All member parameters are mandatory except:
+ *	-ep
+ *	-src_addr
+ */
+struct pbl_image {
+	char *rcw_nm;		/* Input RCW File */
+	char *sec_imgnm;	/* Input BL2 binary */
+	char *imagefile;	/* Generated output file */
+	boot_src_t boot_src;	/* Boot Source - QSPI, SD, NOR, NAND etc */
+	uint32_t src_addr;	/* Source Address */
+	uint32_t addr;		/* Load address */
+	uint32_t ep;		/* Entry point <opt> default is load address */
+	chassis_t chassis;	/* Chassis type */
+	bool src_addr_valid;	/* Source Address given */
+	bool bootptr;		/* Add boot location pointer command */
+	bool sb;		/* Secure Boot */
+};
+
+/* Image being built in memory */
+struct pbl_buf {
+	uint8_t *data;
+	size_t len;
+	size_t size;
+};
+
+chassis_t pbl_soc_chassis(int soc);
+boot_src_t pbl_boot_src(const char *name);
+const char *pbl_boot_src_string(boot_src_t boot_src);
+
+uint32_t pbl_crc32(uint32_t crc, const uint8_t *buf, size_t len);
+uint32_t pbl_crc32_msb(uint32_t crc, const uint8_t *buf, size_t len);
+
+int pbl_build(const struct pbl_image *img, const uint8_t *rcw, size_t rcw_len,
+	      const uint8_t *bl2, size_t bl2_len, struct pbl_buf *out);
+void pbl_buf_free(struct pbl_buf *buf);
+
+#endif /* __PBL_BUILDER_H__ */
@@ -38,6 +38,11 @@ static const struct pll_div dpll_rates_table[] = {
 struct rk3399_dram_status {
 	uint32_t current_index;
 	uint32_t index_freq[2];
+	/*
+	 * Bit n is set while the registers of index n hold the settings for
+	 * index_freq[n] with the current timing_config.
+	 */
+	uint32_t index_valid;
 	uint32_t boot_freq;
 	uint32_t low_power_stat;
 	struct timing_related_config timing_config;
@@ -55,6 +60,13 @@ static struct rk3399_saved_status rk3399_suspend_status;
 static uint32_t wrdqs_delay_val[2][2][4];
 static uint32_t rddqs_delay_ps;
 
+/*
+ * Spec timings of each entry of dpll_rates_table, computed once for the ODT
+ * setting in dram_timing_odt rather than at every frequency switch.
+ */
+static struct dram_timing_t dram_timing_table[ARRAY_SIZE(dpll_rates_table)];
+static uint32_t dram_timing_odt = ~0U;
+
 static struct rk3399_sdram_default_config ddr3_default_config = {
 	.bl = 8,
 	.ap = 0,
@@ -1827,6 +1839,32 @@ static void dram_low_power_config(void)
 	mmio_write_32(CIC_BASE + CIC_CTRL1, 0x00150014);
 }
 
+static void set_timing_config_freq(uint32_t mhz)
+{
+	rk3399_dram_status.timing_config.freq = mhz;
+
+	if (mhz < 300)
+		rk3399_dram_status.timing_config.dllbp = 1;
+	else
+		rk3399_dram_status.timing_config.dllbp = 0;
+}
+
+static void dram_timing_table_init(void)
+{
+	uint32_t i, mhz;
+
+	mhz = rk3399_dram_status.timing_config.freq;
+
+	for (i = 0; i < ARRAY_SIZE(dpll_rates_table); i++) {
+		set_timing_config_freq(dpll_rates_table[i].mhz);
+		dram_get_parameter(&rk3399_dram_status.timing_config,
+				   &dram_timing_table[i]);
+	}
+
+	set_timing_config_freq(mhz);
+	dram_timing_odt = rk3399_dram_status.timing_config.odt;
+}
+
 void dram_dfs_init(void)
 {
 	uint32_t trefi0, trefi1, boot_freq;
@@ -1859,6 +1897,8 @@ void dram_dfs_init(void)
 	rk3399_dram_status.index_freq[(rk3399_dram_status.current_index + 1) &
 				      0x1] = 0;
 	rk3399_dram_status.low_power_stat = 0;
+	rk3399_dram_status.index_valid = 0;
+	dram_timing_table_init();
 	/*
 	 * following register decide if NOC stall the access request
 	 * or return error when NOC being idled. when doing ddr frequency
@@ -1924,6 +1964,7 @@ uint32_t dram_set_odt_pd(uint32_t arg0, uint32_t arg1, uint32_t arg2)
 	lp_cfg->srpd_lite_idle = (arg1 >> 16) & 0xfff;
 
 	rk3399_dram_status.timing_config.odt = arg2 & 0x1;
+	rk3399_dram_status.index_valid = 0;
 
 	exit_low_power();
 
@@ -1978,33 +2019,62 @@ static void m0_configure_ddr(struct pll_div pll_div, uint32_t ddr_index)
 static uint32_t prepare_ddr_timing(uint32_t mhz)
 {
 	uint32_t index;
-	struct dram_timing_t dram_timing;
-
-	rk3399_dram_status.timing_config.freq = mhz;
+	struct dram_timing_t *dram_timing;
 
-	if (mhz < 300)
-		rk3399_dram_status.timing_config.dllbp = 1;
-	else
-		rk3399_dram_status.timing_config.dllbp = 0;
+	set_timing_config_freq(mhz);
 
 	if (rk3399_dram_status.timing_config.odt == 1)
 		gen_rk3399_set_odt(1);
 
 	index = (rk3399_dram_status.current_index + 1) & 0x1;
 
+	if (dram_timing_odt != rk3399_dram_status.timing_config.odt)
+		dram_timing_table_init();
+
 	/*
 	 * checking if having available gate traiing timing for
 	 * target freq.
 	 */
-	dram_get_parameter(&rk3399_dram_status.timing_config, &dram_timing);
+	dram_timing = &dram_timing_table[to_get_clk_index(mhz)];
 	gen_rk3399_ctl_params(&rk3399_dram_status.timing_config,
-			      &dram_timing, index);
+			      dram_timing, index);
 	gen_rk3399_pi_params(&rk3399_dram_status.timing_config,
-			     &dram_timing, index);
+			     dram_timing, index);
 	gen_rk3399_phy_params(&rk3399_dram_status.timing_config,
 			      &rk3399_dram_status.drv_odt_lp_cfg,
-			      &dram_timing, index);
+			      dram_timing, index);
 	rk3399_dram_status.index_freq[index] = mhz;
+	rk3399_dram_status.index_valid |= 1 << index;
+
+	return index;
+}
+
+/*
+ * Switching back to the frequency the other index was last set up for, with
+ * an unchanged configuration, does not need its controller and PI registers
+ * to be generated again: they are banked per index (the _f0/_f1 sets). The
+ * PHY parameters are generated again, as the PHY only has one copy of some
+ * of them (index select, PHY_LOW_FREQ_SEL, PLL_CTRL, TCKSRE_WAIT,
+ * CAL_CLK_SELECT, DLL bypass), which hold the values of the last switch.
+ */
+static uint32_t reuse_ddr_timing(uint32_t mhz)
+{
+	uint32_t index;
+
+	index = (rk3399_dram_status.current_index + 1) & 0x1;
+
+	if (((rk3399_dram_status.index_valid & (1 << index)) == 0) ||
+	    (rk3399_dram_status.index_freq[index] != mhz))
+		return prepare_ddr_timing(mhz);
+
+	set_timing_config_freq(mhz);
+
+	if (rk3399_dram_status.timing_config.odt == 1)
+		gen_rk3399_set_odt(1);
+
+	gen_rk3399_phy_params(&rk3399_dram_status.timing_config,
+			      &rk3399_dram_status.drv_odt_lp_cfg,
+			      &dram_timing_table[to_get_clk_index(mhz)], index);
 
 	return index;
 }
@@ -2021,7 +2091,7 @@ uint32_t ddr_set_rate(uint32_t hz)
 	index = to_get_clk_index(mhz);
 	mhz = dpll_rates_table[index].mhz;
 
-	ddr_index = prepare_ddr_timing(mhz);
+	ddr_index = reuse_ddr_timing(mhz);
 	gen_rk3399_enable_training(rk3399_dram_status.timing_config.ch_cnt,
 				   mhz);
 	if (ddr_index > 1)
@@ -2073,6 +2143,7 @@ void ddr_prepare_for_sys_suspend(void)
 	rk3399_suspend_status.odt = rk3399_dram_status.timing_config.odt;
 	rk3399_dram_status.low_power_stat = 0;
 	rk3399_dram_status.timing_config.odt = 1;
+	rk3399_dram_status.index_valid = 0;
 	if (mhz != rk3399_dram_status.boot_freq)
 		ddr_set_rate(rk3399_dram_status.boot_freq * 1000 * 1000);
 
@@ -2096,6 +2167,7 @@ void ddr_prepare_for_sys_resume(void)
 	rk3399_dram_status.low_power_stat =
 		rk3399_suspend_status.low_power_stat;
 	rk3399_dram_status.timing_config.odt = rk3399_suspend_status.odt;
+	rk3399_dram_status.index_valid = 0;
 
 	/*
 	 * Set the saved frequency from suspend if it's different than the
@@ -41,6 +41,10 @@ endif
 ZYNQMP_CONSOLE	?=	cadence
 $(eval $(call add_define_val,ZYNQMP_CONSOLE,ZYNQMP_CONSOLE_ID_${ZYNQMP_CONSOLE}))
 
+ZYNQMP_IPI_ASYNC_SEND	?=	0
+$(eval $(call assert_boolean,ZYNQMP_IPI_ASYNC_SEND))
+$(eval $(call add_define,ZYNQMP_IPI_ASYNC_SEND))
+
 PLAT_INCLUDES		:=	-Iinclude/plat/arm/common/			\
 				-Iinclude/plat/arm/common/aarch64/		\
 				-Iplat/xilinx/zynqmp/include/			\
@@ -26,6 +26,16 @@
 #define IPI_BUFFER_REQ_OFFSET	0x0U
 #define IPI_BUFFER_RESP_OFFSET	0x20U
 
+/*
+ * Requests without a response are posted: the caller does not wait for the
+ * PMU to take them, the next request does before reusing the buffer.
+ */
+#if ZYNQMP_IPI_ASYNC_SEND
+#define IPI_SEND_NO_RESP_BLOCKING	0U
+#else
+#define IPI_SEND_NO_RESP_BLOCKING	1U
+#endif
+
 DEFINE_BAKERY_LOCK(pm_secure_lock);
 
 const struct pm_ipi apu_ipi = {
@@ -56,6 +66,7 @@ int pm_ipi_init(const struct pm_proc *proc)
  * pm_ipi_send_common() - Sends IPI request to the PMU
  * @proc	Pointer to the processor who is initiating request
  * @payload	API id and call arguments to be written in IPI buffer
+ * @is_blocking	Wait for the PMU to take the request before returning
  *
  * Send an IPI request to the power controller. Caller needs to hold
  * the 'pm_secure_lock' lock.
@@ -63,20 +74,30 @@ int pm_ipi_init(const struct pm_proc *proc)
  * @return	Returns status, either success or error+reason
  */
 static enum pm_ret_status pm_ipi_send_common(const struct pm_proc *proc,
-					     uint32_t payload[PAYLOAD_ARG_CNT])
+					     uint32_t payload[PAYLOAD_ARG_CNT],
+					     uint32_t is_blocking)
 {
 	unsigned int offset = 0;
 	uintptr_t buffer_base = proc->ipi->buffer_base +
 					IPI_BUFFER_TARGET_PMU_OFFSET +
 					IPI_BUFFER_REQ_OFFSET;
 
+#if ZYNQMP_IPI_ASYNC_SEND
+	/* Wait for the PMU to take the previous, posted, request */
+	while (ipi_mb_enquire_status(proc->ipi->apu_ipi_id,
+				     proc->ipi->pmu_ipi_id) &
+	       IPI_MB_STATUS_SEND_PENDING)
+		;
+#endif
+
 	/* Write payload into IPI buffer */
 	for (size_t i = 0; i < PAYLOAD_ARG_CNT; i++) {
 		mmio_write_32(buffer_base + offset, payload[i]);
 		offset += PAYLOAD_ARG_SIZE;
 	}
 	/* Generate IPI to PMU */
-	ipi_mb_notify(proc->ipi->apu_ipi_id, proc->ipi->pmu_ipi_id, 1);
+	ipi_mb_notify(proc->ipi->apu_ipi_id, proc->ipi->pmu_ipi_id,
+		      is_blocking);
 
 	return PM_RET_SUCCESS;
 }
@@ -86,7 +107,8 @@ static enum pm_ret_status pm_ipi_send_common(const struct pm_proc *proc,
  * @proc	Pointer to the processor who is initiating request
  * @payload	API id and call arguments to be written in IPI buffer
  *
- * Send an IPI request to the power controller.
+ * Send an IPI request to the power controller. If ZYNQMP_IPI_ASYNC_SEND is
+ * set, return without waiting for the power controller to take it.
  *
  * @return	Returns status, either success or error+reason
  */
@@ -97,7 +119,7 @@ enum pm_ret_status pm_ipi_send(const struct pm_proc *proc,
 
 	bakery_lock_get(&pm_secure_lock);
 
-	ret = pm_ipi_send_common(proc, payload);
+	ret = pm_ipi_send_common(proc, payload, IPI_SEND_NO_RESP_BLOCKING);
 
 	bakery_lock_release(&pm_secure_lock);
 
@@ -179,7 +201,7 @@ enum pm_ret_status pm_ipi_send_sync(const struct pm_proc *proc,
 
 	bakery_lock_get(&pm_secure_lock);
 
-	ret = pm_ipi_send_common(proc, payload);
+	ret = pm_ipi_send_common(proc, payload, 1);
 	if (ret != PM_RET_SUCCESS)
 		goto unlock;
 
@@ -335,6 +335,111 @@ static int spm_memory_attributes_set_smc_handler(u_register_t page_address,
 	return (ret == 0) ? SPM_SUCCESS : SPM_INVALID_PARAMETER;
 }
 
+/*******************************************************************************
+ * Checks that a MM_COMMUNICATE_BATCH table lies in the Non-secure buffer shared
+ * with the Secure Partition.
+ ******************************************************************************/
+static int spm_mm_batch_table_valid(uintptr_t table, uint64_t count)
+{
+	const secure_partition_boot_info_t *sp_boot_info =
+			plat_get_secure_partition_boot_info(NULL);
+	uintptr_t buf_base = sp_boot_info->sp_ns_comm_buf_base;
+	size_t buf_size = sp_boot_info->sp_ns_comm_buf_size;
+	size_t table_size;
+
+	if ((count == 0) || (count > MM_COMMUNICATE_BATCH_MAX))
+		return 0;
+
+	if ((table & (sizeof(uint64_t) - 1)) != 0)
+		return 0;
+
+	/* Check the table size first so that the subtraction cannot wrap */
+	table_size = count * sizeof(mm_communicate_batch_entry_t);
+	if (table_size > buf_size)
+		return 0;
+
+	return (table >= buf_base) &&
+	       ((table - buf_base) <= (buf_size - table_size));
+}
+
+/*******************************************************************************
+ * Sets up the entry into the Secure Partition for the next request of the
+ * MM_COMMUNICATE_BATCH being run. Requests with invalid arguments are failed
+ * without entering the partition. Returns 0 if there is no request left.
+ ******************************************************************************/
+static int spm_mm_batch_next(void)
+{
+	mm_communicate_batch_entry_t *entry;
+
+	while (sp_ctx.batch_next < sp_ctx.batch_count) {
+		entry = &sp_ctx.batch[sp_ctx.batch_next];
+
+		if (entry->comm_buffer_address != 0) {
+			write_ctx_reg(get_gpregs_ctx(&sp_ctx.cpu_ctx), CTX_GPREG_X0,
+				      MM_COMMUNICATE_AARCH64);
+			write_ctx_reg(get_gpregs_ctx(&sp_ctx.cpu_ctx), CTX_GPREG_X1,
+				      entry->comm_buffer_address);
+			write_ctx_reg(get_gpregs_ctx(&sp_ctx.cpu_ctx), CTX_GPREG_X2,
+				      entry->comm_size_address);
+			write_ctx_reg(get_gpregs_ctx(&sp_ctx.cpu_ctx), CTX_GPREG_X3,
+				      plat_my_core_pos());
+			return 1;
+		}
+
+		ERROR("MM_COMMUNICATE_BATCH: comm_buffer_address is zero\n");
+		entry->ret = SPM_INVALID_PARAMETER;
+		sp_ctx.batch_next++;
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * MM_COMMUNICATE_BATCH, called from the Arm SiP service on behalf of the
+ * Non-secure world. Enters the Secure Partition with the first valid request
+ * of the table. The Normal world only gets control back once all the requests
+ * of the table have completed, see SP_EVENT_COMPLETE_AARCH64.
+ ******************************************************************************/
+uint64_t spm_mm_communicate_batch(uint64_t mm_cookie, uint64_t table_address,
+				  uint64_t table_count, void *handle)
+{
+	/* Cookie. Reserved for future use. It must be zero. */
+	if (mm_cookie != 0) {
+		ERROR("MM_COMMUNICATE_BATCH: cookie is not zero\n");
+		SMC_RET1(handle, SPM_INVALID_PARAMETER);
+	}
+
+	if (!spm_mm_batch_table_valid(table_address, table_count)) {
+		ERROR("MM_COMMUNICATE_BATCH: invalid table\n");
+		SMC_RET1(handle, SPM_INVALID_PARAMETER);
+	}
+
+	/* Save the Normal world context */
+	cm_el1_sysregs_context_save(NON_SECURE);
+
+	/* Lock the Secure Partition context. */
+	spin_lock(&sp_ctx.lock);
+
+	sp_ctx.batch = (mm_communicate_batch_entry_t *)table_address;
+	sp_ctx.batch_count = table_count;
+	sp_ctx.batch_next = 0;
+
+	if (spm_mm_batch_next() == 0) {
+		/* All the requests were invalid */
+		sp_ctx.batch = NULL;
+		spin_unlock(&sp_ctx.lock);
+		SMC_RET1(handle, SPM_SUCCESS);
+	}
+
+	/*
+	 * Restore the secure world context and prepare for entry in S-EL0
+	 */
+	assert(&sp_ctx.cpu_ctx == cm_get_context(SECURE));
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+
+	return (uint64_t)&sp_ctx.cpu_ctx;
+}
 
 uint64_t spm_smc_handler(uint32_t smc_fid,
 			 uint64_t x1,
@@ -377,6 +482,20 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 				assert(0);
 			}
 
+			if (sp_ctx.batch != NULL) {
+				/*
+				 * Record the result of the batched request and
+				 * go on with the next one, if any, without
+				 * returning to the Normal world in between.
+				 */
+				sp_ctx.batch[sp_ctx.batch_next++].ret = x1;
+				if (spm_mm_batch_next() != 0)
+					return (uint64_t)handle;
+
+				sp_ctx.batch = NULL;
+				x1 = SPM_SUCCESS;
+			}
+
 			/* Release the Secure Partition context */
 			spin_unlock(&sp_ctx.lock);
 
@@ -32,6 +32,7 @@
 
 #ifndef __ASSEMBLY__
 
+#include <mm_svc.h>
 #include <spinlock.h>
 #include <stdint.h>
 #include <xlat_tables_v2.h>
@@ -46,6 +47,10 @@ typedef struct secure_partition_context {
 	cpu_context_t cpu_ctx;
 	unsigned int sp_init_in_progress;
 	spinlock_t lock;
+	/* MM_COMMUNICATE_BATCH request being run, if any */
+	mm_communicate_batch_entry_t *batch;
+	unsigned int batch_count;
+	unsigned int batch_next;
 } secure_partition_context_t;
 
 uint64_t spm_secure_partition_enter(uint64_t *c_rt_ctx);
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef WORK_H_
+#define WORK_H_
+
+typedef void (*work_fn_t)(void *arg);
+
+/* Exported API */
+int work_max_jobs(void);
+void work_run(work_fn_t fn, void **args, int num, int jobs);
+
+#endif /* WORK_H_ */
@@ -33,6 +33,7 @@
 #include "tbbr/tbb_cert.h"
 #include "tbbr/tbb_ext.h"
 #include "tbbr/tbb_key.h"
+#include "work.h"
 
 /*
  * Helper macros to simplify the code. This macro assigns the return value of
@@ -72,6 +73,18 @@ static int hash_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int jobs;
+static const char *hash_cache;
+
+/* Key, image hash or certificate to create in a worker thread */
+typedef struct job_s {
+	key_t *key;
+	const char *fn;
+	cert_t *cert;
+	STACK_OF(X509_EXTENSION) * sk;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	int ok;
+} job_t;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -170,6 +183,76 @@ static int get_hash_alg(const char *hash_alg_str)
 	return -1;
 }
 
+static void create_key_job(void *arg)
+{
+	job_t *job = arg;
+
+	job->ok = key_create(job->key, key_alg);
+}
+
+static void hash_job(void *arg)
+{
+	job_t *job = arg;
+
+	job->ok = sha_file(hash_alg, job->fn, job->md);
+}
+
+static void cert_job(void *arg)
+{
+	job_t *job = arg;
+
+	job->ok = cert_new(key_alg, hash_alg, job->cert, VAL_DAYS, 0, job->sk);
+}
+
+/*
+ * Run 'fn' on the jobs in the worker threads. Only the jobs which are 'ready'
+ * are run if a 'ready' array is given.
+ */
+static void run_jobs(work_fn_t fn, job_t *job, int num, const int *ready)
+{
+	void **args;
+	int i, n = 0;
+
+	if (num == 0) {
+		return;
+	}
+
+	CHECK_NULL(args, malloc(num * sizeof(*args)));
+	for (i = 0; i < num; i++) {
+		if ((ready == NULL) || ready[i]) {
+			args[n++] = &job[i];
+		}
+	}
+
+	work_run(fn, args, n, jobs);
+	free(args);
+}
+
+/*
+ * Certificate 'i' can be signed once the certificates it depends on are. In
+ * the sequential order, a certificate is signed by its issuer certificate if
+ * that one comes first, and it is self signed otherwise. That order must be
+ * kept, so the issuer is either signed before it, or only after it.
+ */
+static int cert_ready(int i, const int *done)
+{
+	cert_t *cert = &certs[i];
+	int j;
+
+	if ((cert->issuer < i) && certs[cert->issuer].fn &&
+	    !done[cert->issuer]) {
+		return 0;
+	}
+
+	for (j = 0; j < i; j++) {
+		if ((certs[j].issuer == i) && certs[j].fn && !done[j]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 static void check_cmd_params(void)
 {
 	cert_t *cert;
@@ -262,6 +345,16 @@ PKCS#1 v2.1, 'rsa_1_5' - RSA PKCS#1 v1.5, 'ecdsa'"
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to create keys, hash images and sign \
+certificates (default: 1, 0: one per CPU)"
+	},
+	{
+		{ "hash-cache", required_argument, NULL, 'c' },
+		"File in which image hashes are kept across runs, and reused \
+until the images change"
 	}
 };
 
@@ -281,6 +374,9 @@ int main(int argc, char *argv[])
 	unsigned char md[SHA512_DIGEST_LENGTH];
 	unsigned int  md_len;
 	const EVP_MD *md_info;
+	job_t *key_jobs, *hash_jobs, *cert_jobs;
+	int num_key_jobs = 0, num_hash_jobs = 0;
+	int *hash_idx, *ready, *done, left;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -288,6 +384,7 @@ int main(int argc, char *argv[])
 	/* Set default options */
 	key_alg = KEY_ALG_RSA;
 	hash_alg = HASH_ALG_SHA256;
+	jobs = 1;
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -317,7 +414,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:c:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -332,9 +429,22 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			hash_cache = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			break;
+		case 'j':
+			jobs = atoi(optarg);
+			if (jobs < 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			if (jobs == 0) {
+				jobs = work_max_jobs();
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -376,6 +486,16 @@ int main(int argc, char *argv[])
 	/* Check command line arguments */
 	check_cmd_params();
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+	/* OpenSSL needs locking callbacks to be used from several threads */
+	jobs = 1;
+#endif
+
+	if (hash_cache && !sha_cache_load(hash_cache)) {
+		ERROR("Cannot load hash cache %s\n", hash_cache);
+		exit(1);
+	}
+
 	/* Indicate SHA as image hash algorithm in the certificate
 	 * extension */
 	if (hash_alg == HASH_ALG_SHA384) {
@@ -390,6 +510,7 @@ int main(int argc, char *argv[])
 	}
 
 	/* Load private keys from files (or generate new ones) */
+	CHECK_NULL(key_jobs, calloc(num_keys, sizeof(*key_jobs)));
 	for (i = 0 ; i < num_keys ; i++) {
 		if (!key_new(&keys[i])) {
 			ERROR("Failed to allocate key container\n");
@@ -415,10 +536,7 @@ int main(int argc, char *argv[])
 		if (new_keys) {
 			/* Try to create a new key */
 			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
+			key_jobs[num_key_jobs++].key = &keys[i];
 		} else {
 			if (err_code == KEY_ERR_OPEN) {
 				ERROR("Error opening '%s'\n", keys[i].fn);
@@ -429,7 +547,42 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	/* Create the certificates */
+	/* Create the new keys */
+	run_jobs(create_key_job, key_jobs, num_key_jobs, NULL);
+	for (i = 0 ; i < num_key_jobs ; i++) {
+		if (!key_jobs[i].ok) {
+			ERROR("Error creating key '%s'\n", key_jobs[i].key->desc);
+			exit(1);
+		}
+	}
+	free(key_jobs);
+
+	/* Calculate the hash of all the images, each file only once */
+	CHECK_NULL(hash_jobs, calloc(num_extensions, sizeof(*hash_jobs)));
+	CHECK_NULL(hash_idx, calloc(num_extensions, sizeof(*hash_idx)));
+	for (i = 0 ; i < num_extensions ; i++) {
+		ext = &extensions[i];
+		if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL)) {
+			continue;
+		}
+		for (j = 0 ; j < num_hash_jobs ; j++) {
+			if (strcmp(hash_jobs[j].fn, ext->arg) == 0) {
+				break;
+			}
+		}
+		if (j == num_hash_jobs) {
+			hash_jobs[num_hash_jobs++].fn = ext->arg;
+		}
+		hash_idx[i] = j;
+	}
+	run_jobs(hash_job, hash_jobs, num_hash_jobs, NULL);
+
+	if (hash_cache && !sha_cache_save(hash_cache)) {
+		ERROR("Cannot save hash cache %s\n", hash_cache);
+	}
+
+	/* Create the certificate extensions */
+	CHECK_NULL(cert_jobs, calloc(num_certs, sizeof(*cert_jobs)));
 	for (i = 0 ; i < num_certs ; i++) {
 
 		cert = &certs[i];
@@ -469,12 +622,15 @@ int main(int argc, char *argv[])
 						break;
 					}
 				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
+					/* The hash of the file was calculated above */
+					job_t *job = &hash_jobs[hash_idx[cert->ext[j]]];
+
+					if (!job->ok) {
 						ERROR("Cannot calculate hash of %s\n",
 							ext->arg);
 						exit(1);
 					}
+					memcpy(md, job->md, md_len);
 				}
 				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
 						EXT_CRIT, md_info, md,
@@ -494,14 +650,47 @@ int main(int argc, char *argv[])
 			sk_X509_EXTENSION_push(sk, cert_ext);
 		}
 
-		/* Create certificate. Signed with corresponding key */
-		if (cert->fn && !cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
+		cert_jobs[i].cert = cert;
+		cert_jobs[i].sk = sk;
+	}
+	free(hash_idx);
+	free(hash_jobs);
+
+	/*
+	 * Create the certificates. Signed with corresponding key, in rounds of
+	 * certificates which do not depend on each other.
+	 */
+	CHECK_NULL(ready, calloc(num_certs, sizeof(*ready)));
+	CHECK_NULL(done, calloc(num_certs, sizeof(*done)));
+	for (i = 0 ; i < num_certs ; i++) {
+		done[i] = (certs[i].fn == NULL);
+	}
+	do {
+		left = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			ready[i] = !done[i] && cert_ready(i, done);
+			left += !done[i];
+		}
+		run_jobs(cert_job, cert_jobs, num_certs, ready);
+		for (i = 0 ; i < num_certs ; i++) {
+			if (!ready[i]) {
+				continue;
+			}
+			if (!cert_jobs[i].ok) {
+				ERROR("Cannot create %s\n", certs[i].cn);
+				exit(1);
+			}
+			done[i] = 1;
+			left--;
 		}
+	} while (left > 0);
+	free(ready);
+	free(done);
 
-		sk_X509_EXTENSION_free(sk);
+	for (i = 0 ; i < num_certs ; i++) {
+		sk_X509_EXTENSION_free(cert_jobs[i].sk);
 	}
+	free(cert_jobs);
 
 
 	/* Print the certificates */
@@ -1,55 +1,409 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
-#include <openssl/sha.h>
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
 #include "debug.h"
 #include "key.h"
+#include "sha.h"
+
+#define BUFFER_SIZE	(64 * 1024)
+/* Amount of a mapped file passed to the digest at once */
+#define MAP_CHUNK_SIZE	(1024 * 1024)
+
+/* First line of the cache file, for the format written by sha_cache_save() */
+#define CACHE_HEADER	"# cert_create hash cache v2"
+
+/*
+ * File attributes a cached digest depends on. The inode and the status change
+ * time catch a file replaced by another one, or modified without its
+ * modification time changing, such as a copy preserving timestamps.
+ */
+typedef struct sha_cache_key_s {
+	unsigned long long dev;
+	unsigned long long ino;
+	long long size;
+	long long mtime_sec;
+	long mtime_nsec;
+	long long ctime_sec;
+	long ctime_nsec;
+} sha_cache_key_t;
+
+/*
+ * Image digest cache entry. A digest is reused as long as the file keeps the
+ * same key.
+ */
+typedef struct sha_cache_entry_s {
+	char *path;
+	int md_alg;
+	sha_cache_key_t key;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+} sha_cache_entry_t;
+
+static sha_cache_entry_t *cache;
+static int cache_num;
+static int cache_enabled;
+static int cache_dirty;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const EVP_MD *get_md(int md_alg)
+{
+	if (md_alg == HASH_ALG_SHA384) {
+		return EVP_sha384();
+	} else if (md_alg == HASH_ALG_SHA512) {
+		return EVP_sha512();
+	} else {
+		return EVP_sha256();
+	}
+}
 
-#define BUFFER_SIZE	256
+static int md_size(int md_alg)
+{
+	return EVP_MD_size(get_md(md_alg));
+}
+
+/* Find a cache entry, the lock must be held */
+static sha_cache_entry_t *cache_find(const char *path, int md_alg)
+{
+	int i;
+
+	for (i = 0; i < cache_num; i++) {
+		if ((cache[i].md_alg == md_alg) &&
+		    (strcmp(cache[i].path, path) == 0)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void cache_key(const struct stat *st, sha_cache_key_t *key)
+{
+	memset(key, 0, sizeof(*key));
+	key->dev = st->st_dev;
+	key->ino = st->st_ino;
+	key->size = st->st_size;
+	key->mtime_sec = st->st_mtim.tv_sec;
+	key->mtime_nsec = st->st_mtim.tv_nsec;
+	key->ctime_sec = st->st_ctim.tv_sec;
+	key->ctime_nsec = st->st_ctim.tv_nsec;
+}
+
+static int cache_key_equal(const sha_cache_key_t *a, const sha_cache_key_t *b)
+{
+	return (a->dev == b->dev) && (a->ino == b->ino) &&
+	       (a->size == b->size) &&
+	       (a->mtime_sec == b->mtime_sec) &&
+	       (a->mtime_nsec == b->mtime_nsec) &&
+	       (a->ctime_sec == b->ctime_sec) &&
+	       (a->ctime_nsec == b->ctime_nsec);
+}
+
+static int cache_lookup(const char *path, int md_alg, const struct stat *st,
+			unsigned char *md)
+{
+	sha_cache_entry_t *entry;
+	sha_cache_key_t key;
+	int found = 0;
+
+	cache_key(st, &key);
+
+	pthread_mutex_lock(&cache_lock);
+	entry = cache_find(path, md_alg);
+	if ((entry != NULL) && cache_key_equal(&entry->key, &key)) {
+		memcpy(md, entry->md, md_size(md_alg));
+		found = 1;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	return found;
+}
+
+static int cache_add(const char *path, int md_alg, const sha_cache_key_t *key,
+		     const unsigned char *md)
+{
+	sha_cache_entry_t *entry, *new_cache;
+
+	entry = cache_find(path, md_alg);
+	if (entry == NULL) {
+		new_cache = realloc(cache, (cache_num + 1) * sizeof(*cache));
+		if (new_cache == NULL) {
+			return 0;
+		}
+		cache = new_cache;
+		entry = &cache[cache_num];
+		entry->path = strdup(path);
+		if (entry->path == NULL) {
+			return 0;
+		}
+		entry->md_alg = md_alg;
+		cache_num++;
+	}
+
+	entry->key = *key;
+	memcpy(entry->md, md, md_size(md_alg));
+
+	return 1;
+}
+
+static void cache_store(const char *path, int md_alg, const struct stat *st,
+			const unsigned char *md)
+{
+	sha_cache_key_t key;
+
+	cache_key(st, &key);
+
+	pthread_mutex_lock(&cache_lock);
+	if (cache_add(path, md_alg, &key, md)) {
+		cache_dirty = 1;
+	}
+	pthread_mutex_unlock(&cache_lock);
+}
+
+/*
+ * Feed the file to the digest. Regular files are mapped and fed in large
+ * chunks, anything else is read through a buffer.
+ */
+static int digest_fd(EVP_MD_CTX *ctx, int fd, const struct stat *st)
+{
+	unsigned char *data;
+	size_t off, len;
+	ssize_t bytes;
+	int ret = 1;
+
+	if (S_ISREG(st->st_mode) && (st->st_size > 0)) {
+		data = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			posix_madvise(data, st->st_size,
+				      POSIX_MADV_SEQUENTIAL);
+			for (off = 0; off < (size_t)st->st_size; off += len) {
+				len = st->st_size - off;
+				if (len > MAP_CHUNK_SIZE) {
+					len = MAP_CHUNK_SIZE;
+				}
+				if (!EVP_DigestUpdate(ctx, data + off, len)) {
+					ret = 0;
+					break;
+				}
+			}
+			munmap(data, st->st_size);
+			return ret;
+		}
+	}
+
+	data = malloc(BUFFER_SIZE);
+	if (data == NULL) {
+		return 0;
+	}
+	while ((bytes = read(fd, data, BUFFER_SIZE)) != 0) {
+		if ((bytes < 0) || !EVP_DigestUpdate(ctx, data, bytes)) {
+			ret = 0;
+			break;
+		}
+	}
+	free(data);
+
+	return ret;
+}
+
+static int abs_path(const char *filename, char *path, size_t size)
+{
+	char cwd[PATH_MAX];
+	int n;
+
+	if (filename[0] == '/') {
+		n = snprintf(path, size, "%s", filename);
+	} else if (getcwd(cwd, sizeof(cwd)) != NULL) {
+		n = snprintf(path, size, "%s/%s", cwd, filename);
+	} else {
+		return 0;
+	}
+
+	return (n > 0) && ((size_t)n < size);
+}
 
 int sha_file(int md_alg, const char *filename, unsigned char *md)
 {
-	FILE *inFile;
-	SHA256_CTX shaContext;
-	SHA512_CTX sha512Context;
-	int bytes;
-	unsigned char data[BUFFER_SIZE];
+	char path[PATH_MAX];
+	struct stat st;
+	EVP_MD_CTX *ctx;
+	int fd, ret = 0;
 
 	if ((filename == NULL) || (md == NULL)) {
 		ERROR("%s(): NULL argument\n", __FUNCTION__);
 		return 0;
 	}
 
-	inFile = fopen(filename, "rb");
-	if (inFile == NULL) {
+	fd = open(filename, O_RDONLY);
+	if ((fd < 0) || (fstat(fd, &st) != 0)) {
 		ERROR("Cannot read %s\n", filename);
+		if (fd >= 0) {
+			close(fd);
+		}
 		return 0;
 	}
 
-	if (md_alg == HASH_ALG_SHA384) {
-		SHA384_Init(&sha512Context);
-		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-			SHA384_Update(&sha512Context, data, bytes);
+	/* The cache is keyed on the absolute path of the image */
+	if (cache_enabled && S_ISREG(st.st_mode) &&
+	    abs_path(filename, path, sizeof(path))) {
+		if (cache_lookup(path, md_alg, &st, md)) {
+			close(fd);
+			return 1;
 		}
-		SHA384_Final(md, &sha512Context);
-	} else if (md_alg == HASH_ALG_SHA512) {
-		SHA512_Init(&sha512Context);
-		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-			SHA512_Update(&sha512Context, data, bytes);
-		}
-		SHA512_Final(md, &sha512Context);
 	} else {
-		SHA256_Init(&shaContext);
-		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-			SHA256_Update(&shaContext, data, bytes);
+		path[0] = '\0';
+	}
+
+	ctx = EVP_MD_CTX_create();
+	if (ctx == NULL) {
+		close(fd);
+		return 0;
+	}
+
+	if (EVP_DigestInit_ex(ctx, get_md(md_alg), NULL) &&
+	    digest_fd(ctx, fd, &st) &&
+	    EVP_DigestFinal_ex(ctx, md, NULL)) {
+		ret = 1;
+	} else {
+		ERROR("Cannot calculate hash of %s\n", filename);
+	}
+
+	EVP_MD_CTX_destroy(ctx);
+	close(fd);
+
+	if (ret && (path[0] != '\0')) {
+		cache_store(path, md_alg, &st, md);
+	}
+
+	return ret;
+}
+
+/*
+ * Load the image digests saved by a previous run. A missing cache file is
+ * not an error, as it is created by sha_cache_save(), and a cache file in
+ * another format is ignored.
+ *
+ * After the header, each line holds: algorithm dev ino size mtime_sec
+ * mtime_nsec ctime_sec ctime_nsec digest path
+ */
+int sha_cache_load(const char *filename)
+{
+	char line[PATH_MAX + 256], hex[2 * SHA512_DIGEST_LENGTH + 1];
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	sha_cache_key_t key;
+	int md_alg, n, i;
+	FILE *file;
+
+	cache_enabled = 1;
+
+	file = fopen(filename, "r");
+	if (file == NULL) {
+		return 1;
+	}
+
+	if ((fgets(line, sizeof(line), file) == NULL) ||
+	    (strcmp(line, CACHE_HEADER "\n") != 0)) {
+		fclose(file);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		line[strcspn(line, "\n")] = '\0';
+		if (sscanf(line, "%d %llu %llu %lld %lld %ld %lld %ld %128s %n",
+			   &md_alg, &key.dev, &key.ino, &key.size,
+			   &key.mtime_sec, &key.mtime_nsec, &key.ctime_sec,
+			   &key.ctime_nsec, hex, &n) != 9) {
+			continue;
+		}
+		if ((md_alg < HASH_ALG_SHA256) || (md_alg > HASH_ALG_SHA512) ||
+		    (strlen(hex) != 2 * md_size(md_alg)) ||
+		    (line[n] != '/')) {
+			continue;
+		}
+		for (i = 0; i < md_size(md_alg); i++) {
+			if (sscanf(&hex[2 * i], "%2hhx", &md[i]) != 1) {
+				break;
+			}
+		}
+		if (i != md_size(md_alg)) {
+			continue;
+		}
+		if (!cache_add(&line[n], md_alg, &key, md)) {
+			fclose(file);
+			return 0;
 		}
-		SHA256_Final(md, &shaContext);
 	}
 
-	fclose(inFile);
+	fclose(file);
 	return 1;
 }
+
+/*
+ * Save the image digests for the next run if any of them changed. The cache
+ * file is replaced atomically, so that it is never left truncated.
+ */
+int sha_cache_save(const char *filename)
+{
+	char tmp[PATH_MAX];
+	const sha_cache_key_t *key;
+	FILE *file;
+	int i, j, n, ret = 1;
+
+	if (!cache_dirty) {
+		return 1;
+	}
+
+	n = snprintf(tmp, sizeof(tmp), "%s.tmp", filename);
+	if ((n < 0) || ((size_t)n >= sizeof(tmp))) {
+		ERROR("Hash cache file name too long: %s\n", filename);
+		return 0;
+	}
+	file = fopen(tmp, "w");
+	if (file == NULL) {
+		return 0;
+	}
+
+	fprintf(file, "%s\n", CACHE_HEADER);
+	for (i = 0; i < cache_num; i++) {
+		key = &cache[i].key;
+		fprintf(file, "%d %llu %llu %lld %lld %ld %lld %ld ",
+			cache[i].md_alg, key->dev, key->ino, key->size,
+			key->mtime_sec, key->mtime_nsec, key->ctime_sec,
+			key->ctime_nsec);
+		for (j = 0; j < md_size(cache[i].md_alg); j++) {
+			fprintf(file, "%02x", cache[i].md[j]);
+		}
+		fprintf(file, " %s\n", cache[i].path);
+	}
+
+	if (ferror(file)) {
+		ret = 0;
+	}
+	if (fclose(file) != 0) {
+		ret = 0;
+	}
+	if (ret && (rename(tmp, filename) != 0)) {
+		ret = 0;
+	}
+	if (!ret) {
+		remove(tmp);
+	}
+
+	return ret;
+}
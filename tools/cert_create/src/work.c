@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "work.h"
+
+#define MAX_JOBS		64
+
+/* List of calls shared by the worker threads */
+typedef struct work_s {
+	work_fn_t fn;
+	void **args;
+	int num;
+	int next;
+	pthread_mutex_t lock;
+} work_t;
+
+static void *worker(void *arg)
+{
+	work_t *work = arg;
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&work->lock);
+		i = work->next++;
+		pthread_mutex_unlock(&work->lock);
+		if (i >= work->num) {
+			break;
+		}
+		work->fn(work->args[i]);
+	}
+
+	return NULL;
+}
+
+/*
+ * Return the number of CPUs available, which is a sensible number of jobs
+ */
+int work_max_jobs(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (n < 1) {
+		return 1;
+	}
+	if (n > MAX_JOBS) {
+		return MAX_JOBS;
+	}
+	return (int)n;
+}
+
+/*
+ * Call 'fn' on each of the 'num' elements of 'args', using up to 'jobs'
+ * threads. The calling thread is one of them, so with a single job the calls
+ * are simply made in order.
+ */
+void work_run(work_fn_t fn, void **args, int num, int jobs)
+{
+	pthread_t threads[MAX_JOBS];
+	work_t work;
+	int i;
+
+	work.fn = fn;
+	work.args = args;
+	work.num = num;
+	work.next = 0;
+
+	if (jobs > MAX_JOBS) {
+		jobs = MAX_JOBS;
+	}
+	if (jobs > num) {
+		jobs = num;
+	}
+
+	if (pthread_mutex_init(&work.lock, NULL) != 0) {
+		ERROR("Cannot initialize work queue\n");
+		exit(1);
+	}
+
+	for (i = 1; i < jobs; i++) {
+		if (pthread_create(&threads[i], NULL, worker, &work) != 0) {
+			ERROR("Cannot create worker thread\n");
+			exit(1);
+		}
+	}
+	worker(&work);
+	for (i = 1; i < jobs; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&work.lock);
+}
@@ -23,6 +23,14 @@
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
 
+/* Maximum number of worker threads for hashing and unpacking. */
+#define MAX_THREADS 64
+/* Size of the zero buffer used for padding. */
+#define PAD_BUF_SIZE 0x10000
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(void);
 static int create_cmd(int argc, char *argv[]);
@@ -54,6 +62,12 @@ static size_t nr_image_descs;
 static uuid_t uuid_null = { 0 };
 static int verbose;
 
+/* The FIP being processed, which the images parsed from it point into. */
+static void *fip_buf;
+static size_t fip_size;
+static int fip_buf_type;
+static struct BLD_PLAT_STAT fip_st;
+
 static void vlog(int prio, const char *msg, va_list ap)
 {
 	char *prefix[] = { "DEBUG", "WARN", "ERROR" };
@@ -134,6 +148,30 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+static void free_buffer(void *buf, size_t size, int buffer_type)
+{
+	switch (buffer_type) {
+	case BUF_MALLOC:
+		free(buf);
+		break;
+#ifndef _MSC_VER
+	case BUF_MMAP:
+		munmap(buf, size);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+static void free_image(image_t *image)
+{
+	if (image == NULL)
+		return;
+	free_buffer(image->buffer, image->toc_e.size, image->buffer_type);
+	free(image);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -169,7 +207,7 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	free(desc->image);
+	free_image(desc->image);
 	free(desc);
 }
 
@@ -270,29 +308,67 @@ static void uuid_from_str(uuid_t *u, const char *s)
 		log_errx("Invalid UUID: %s", s);
 }
 
-static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
+/*
+ * Load a file in memory. Regular files are mapped rather than read so that
+ * large images are neither copied nor read in full unless they are used.
+ * Returns NULL for an empty file.
+ */
+static void *load_file(const char *filename, struct BLD_PLAT_STAT *st,
+    int *buffer_type)
 {
-	struct BLD_PLAT_STAT st;
 	FILE *fp;
-	char *buf, *bufend;
-	fip_toc_header_t *toc_header;
-	fip_toc_entry_t *toc_entry;
-	int terminated = 0;
+	void *buf;
 
 	fp = fopen(filename, "rb");
 	if (fp == NULL)
 		log_err("fopen %s", filename);
 
-	if (fstat(fileno(fp), &st) == -1)
+	if (fstat(fileno(fp), st) == -1)
 		log_err("fstat %s", filename);
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
+	*buffer_type = BUF_MALLOC;
+	if (st->st_size == 0) {
+		fclose(fp);
+		return NULL;
+	}
+
+#ifndef _MSC_VER
+	buf = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+	if (buf != MAP_FAILED) {
+		posix_madvise(buf, st->st_size, POSIX_MADV_SEQUENTIAL);
+		*buffer_type = BUF_MMAP;
+		fclose(fp);
+		return buf;
+	}
+#endif
+
+	buf = xmalloc(st->st_size, "failed to load file into memory");
+	if (fread(buf, 1, st->st_size, fp) != st->st_size)
 		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
 	fclose(fp);
+	return buf;
+}
+
+static void release_fip(void)
+{
+	free_buffer(fip_buf, fip_size, fip_buf_type);
+	fip_buf = NULL;
+	fip_size = 0;
+}
 
-	if (st.st_size < sizeof(fip_toc_header_t))
+static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
+{
+	char *buf, *bufend;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	int terminated = 0;
+
+	buf = load_file(filename, &fip_st, &fip_buf_type);
+	fip_buf = buf;
+	fip_size = fip_st.st_size;
+	bufend = buf + fip_st.st_size;
+
+	if (fip_st.st_size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
 	toc_header = (fip_toc_header_t *)buf;
@@ -316,23 +392,22 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 			break;
 		}
 
+		/* Overflow checks before using the image in place. */
+		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
+			log_errx("FIP %s is corrupted", filename);
+		if (toc_entry->size + toc_entry->offset_address > fip_st.st_size)
+			log_errx("FIP %s is corrupted", filename);
+
 		/*
 		 * Build a new image out of the ToC entry and add it to the
-		 * table of images.
+		 * table of images. Its buffer points into the FIP, which is
+		 * kept in memory until the end of the command.
 		 */
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
 		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
-		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
-			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
-			log_errx("FIP %s is corrupted", filename);
-
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		image->buffer = buf + toc_entry->offset_address;
+		image->buffer_type = BUF_BORROWED;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -358,7 +433,6 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
 	return 0;
 }
 
@@ -366,26 +440,15 @@ static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 {
 	struct BLD_PLAT_STAT st;
 	image_t *image;
-	FILE *fp;
 
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
+	image->buffer = load_file(filename, &st, &image->buffer_type);
 	image->toc_e.size = st.st_size;
 
-	fclose(fp);
 	return image;
 }
 
@@ -426,6 +489,68 @@ static struct option *fill_common_opts(struct option *opts, size_t *nr_opts,
 	return opts;
 }
 
+#ifndef _MSC_VER
+typedef struct work_queue {
+	void            (*fn)(void *);
+	void            **args;
+	size_t            nr_args;
+	size_t            next;
+	pthread_mutex_t   lock;
+} work_queue_t;
+
+static void *worker(void *arg)
+{
+	work_queue_t *wq = arg;
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&wq->lock);
+		i = wq->next++;
+		pthread_mutex_unlock(&wq->lock);
+		if (i >= wq->nr_args)
+			break;
+		wq->fn(wq->args[i]);
+	}
+	return NULL;
+}
+
+/* Call fn() on each of args[], spreading the calls over the online CPUs. */
+static void run_parallel(void (*fn)(void *), void **args, size_t nr_args)
+{
+	pthread_t threads[MAX_THREADS];
+	work_queue_t wq = { fn, args, nr_args, 0 };
+	long nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t i, nr_threads;
+
+	nr_threads = nr_cpus > 0 ? (size_t)nr_cpus : 1;
+	if (nr_threads > MAX_THREADS)
+		nr_threads = MAX_THREADS;
+	if (nr_threads > nr_args)
+		nr_threads = nr_args;
+
+	if (pthread_mutex_init(&wq.lock, NULL) != 0)
+		log_errx("Failed to initialize work queue");
+
+	/* The calling thread is one of the workers. */
+	for (i = 1; i < nr_threads; i++)
+		if (pthread_create(&threads[i], NULL, worker, &wq) != 0)
+			log_errx("Failed to create worker thread");
+	worker(&wq);
+	for (i = 1; i < nr_threads; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&wq.lock);
+}
+#else
+static void run_parallel(void (*fn)(void *), void **args, size_t nr_args)
+{
+	size_t i;
+
+	for (i = 0; i < nr_args; i++)
+		fn(args[i]);
+}
+#endif
+
 static void md_print(const unsigned char *md, size_t len)
 {
 	size_t i;
@@ -434,10 +559,29 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+typedef struct hash_job {
+	image_t       *image;
+	unsigned char  md[SHA256_DIGEST_LENGTH];
+} hash_job_t;
+
+static void hash_image(void *arg)
+{
+	hash_job_t *job = arg;
+
+	SHA256(job->image->buffer, job->image->toc_e.size, job->md);
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	hash_job_t *jobs = NULL;
+	void **args = NULL;
+	size_t nr_jobs = 0;
+#endif
 
 	if (argc != 2)
 		info_usage();
@@ -454,6 +598,25 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#ifndef _MSC_VER
+	/* Hash all the images up front, in parallel. */
+	if (verbose) {
+		jobs = xzalloc(nr_image_descs * sizeof(*jobs),
+		    "failed to allocate memory for hash jobs");
+		args = xzalloc(nr_image_descs * sizeof(*args),
+		    "failed to allocate memory for hash jobs");
+		for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+			if (desc->image == NULL)
+				continue;
+			jobs[nr_jobs].image = desc->image;
+			args[nr_jobs] = &jobs[nr_jobs];
+			nr_jobs++;
+		}
+		run_parallel(hash_image, args, nr_jobs);
+		nr_jobs = 0;
+	}
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -464,18 +627,20 @@ static int info_cmd(int argc, char *argv[])
 		       (unsigned long long)image->toc_e.offset_address,
 		       (unsigned long long)image->toc_e.size,
 		       desc->cmdline_name);
-#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+#ifndef _MSC_VER
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(jobs[nr_jobs].md, sizeof(jobs[nr_jobs].md));
+			nr_jobs++;
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(args);
+	free(jobs);
+#endif
 	return 0;
 }
 
@@ -485,15 +650,179 @@ static void info_usage(void)
 	exit(1);
 }
 
-static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+static out_seg_t *add_seg(out_seg_t *segs, size_t *nr_segs,
+    const void *buf, size_t len)
+{
+	if (len == 0)
+		return segs;
+	segs = realloc(segs, (*nr_segs + 1) * sizeof(*segs));
+	if (segs == NULL)
+		log_err("realloc");
+	segs[*nr_segs].buf = buf;
+	segs[*nr_segs].len = len;
+	++*nr_segs;
+	return segs;
+}
+
+static out_seg_t *add_pad_segs(out_seg_t *segs, size_t *nr_segs,
+    const void *zero_buf, uint64_t pad_size)
+{
+	while (pad_size > 0) {
+		size_t len = pad_size > PAD_BUF_SIZE ? PAD_BUF_SIZE : pad_size;
+
+		segs = add_seg(segs, nr_segs, zero_buf, len);
+		pad_size -= len;
+	}
+	return segs;
+}
+
+#ifndef _MSC_VER
+static void xwritev(int fd, struct iovec *iov, int cnt, const char *filename)
+{
+	ssize_t ret;
+
+	while (cnt > 0) {
+		ret = writev(fd, iov, cnt);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("Failed to write %s", filename);
+		}
+
+		/* Skip what was written, which may end in the middle of a buffer. */
+		while (cnt > 0 && (size_t)ret >= iov->iov_len) {
+			ret -= iov->iov_len;
+			iov++;
+			cnt--;
+		}
+		if (cnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + ret;
+			iov->iov_len -= ret;
+		}
+	}
+}
+
+/*
+ * Replace the mapping of the FIP with anonymous memory holding the same data,
+ * so that the images pointing into it survive the file being truncated and
+ * rewritten. Truncating a file also drops the private pages of its mappings.
+ */
+static void detach_fip(void)
+{
+	void *copy = xmalloc(fip_size, "failed to copy the FIP");
+
+	memcpy(copy, fip_buf, fip_size);
+	if (mmap(fip_buf, fip_size, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+		log_err("mmap");
+	memcpy(fip_buf, copy, fip_size);
+	free(copy);
+}
+
+/*
+ * Open a temporary file next to `path`, with the mode and owner of the file
+ * described by `st`. Returns -1 if the owner cannot be kept.
+ */
+static int open_tmp_file(const char *path, const struct stat *st,
+    char *tmpfile, size_t len)
+{
+	int fd;
+
+	snprintf(tmpfile, len, "%s.XXXXXX", path);
+	fd = mkstemp(tmpfile);
+	if (fd == -1)
+		log_err("mkstemp %s", tmpfile);
+
+	if ((st->st_uid != geteuid() || st->st_gid != getegid()) &&
+	    fchown(fd, st->st_uid, st->st_gid) == -1) {
+		close(fd);
+		unlink(tmpfile);
+		return -1;
+	}
+	if (fchmod(fd, st->st_mode & 07777) == -1)
+		log_err("fchmod %s", tmpfile);
+	return fd;
+}
+
+/*
+ * Write the FIP with as few system calls as possible. If the output is the
+ * FIP the images are mapped from, truncating it would pull the data from
+ * under the mappings. The new FIP is then written next to the file, a
+ * symbolic link being resolved first, and renamed over it with the same mode
+ * and owner. A file with several links, or whose owner cannot be kept, is
+ * rewritten in place once the mapping no longer depends on it.
+ */
+static void write_fip_file(const char *filename, const out_seg_t *segs,
+    size_t nr_segs)
+{
+	struct iovec iov[IOV_MAX];
+	char path[PATH_MAX], tmpfile[PATH_MAX + 8];
+	struct stat st;
+	size_t i = 0;
+	int fd = -1, use_tmp = 0;
+
+	if (fip_buf_type == BUF_MMAP && stat(filename, &st) == 0 &&
+	    st.st_dev == fip_st.st_dev && st.st_ino == fip_st.st_ino) {
+		if (S_ISREG(st.st_mode) && st.st_nlink == 1 &&
+		    realpath(filename, path) != NULL) {
+			fd = open_tmp_file(path, &st, tmpfile, sizeof(tmpfile));
+			use_tmp = fd != -1;
+		}
+		if (!use_tmp)
+			detach_fip();
+	}
+
+	if (!use_tmp) {
+		fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (fd == -1)
+			log_err("open %s", filename);
+	}
+
+	while (i < nr_segs) {
+		int cnt = 0;
+
+		while (i < nr_segs && cnt < IOV_MAX) {
+			iov[cnt].iov_base = (void *)segs[i].buf;
+			iov[cnt].iov_len = segs[i].len;
+			cnt++;
+			i++;
+		}
+		xwritev(fd, iov, cnt, filename);
+	}
+
+	if (close(fd) == -1)
+		log_err("close %s", filename);
+
+	if (use_tmp && rename(tmpfile, path) == -1)
+		log_err("rename %s", tmpfile);
+}
+#else
+static void write_fip_file(const char *filename, const out_seg_t *segs,
+    size_t nr_segs)
 {
 	FILE *fp;
+	size_t i;
+
+	fp = fopen(filename, "wb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	for (i = 0; i < nr_segs; i++)
+		xfwrite((void *)segs[i].buf, segs[i].len, fp, filename);
+
+	fclose(fp);
+}
+#endif
+
+static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+{
 	image_desc_t *desc;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
-	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
-	size_t nr_images = 0;
+	char *buf, *zero_buf;
+	uint64_t entry_offset, buf_size, payload_size = 0;
+	size_t nr_images = 0, nr_segs = 0;
+	out_seg_t *segs = NULL;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
 		if (desc->image != NULL)
@@ -504,6 +833,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	buf = calloc(1, buf_size);
 	if (buf == NULL)
 		log_err("calloc");
+	zero_buf = xzalloc(PAD_BUF_SIZE, "failed to allocate padding buffer");
 
 	/* Build up header and ToC entries from the image table. */
 	toc_header = (fip_toc_header_t *)buf;
@@ -513,17 +843,28 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
 
+	/*
+	 * Lay out the FIP as a list of pieces, pointing to the images in
+	 * place, which is then written in one go.
+	 */
+	segs = add_seg(segs, &nr_segs, buf, buf_size);
+
 	entry_offset = buf_size;
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
+		uint64_t image_offset;
 
 		if (image == NULL)
 			continue;
 		payload_size += image->toc_e.size;
-		entry_offset = (entry_offset + align - 1) & ~(align - 1);
-		image->toc_e.offset_address = entry_offset;
+		image_offset = (entry_offset + align - 1) & ~(align - 1);
+		segs = add_pad_segs(segs, &nr_segs, zero_buf,
+		    image_offset - entry_offset);
+		segs = add_seg(segs, &nr_segs, image->buffer,
+		    image->toc_e.size);
+		image->toc_e.offset_address = image_offset;
 		*toc_entry++ = image->toc_e;
-		entry_offset += image->toc_e.size;
+		entry_offset = image_offset + image->toc_e.size;
 	}
 
 	/*
@@ -533,40 +874,20 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	 */
 	memset(toc_entry, 0, sizeof(*toc_entry));
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
+	segs = add_pad_segs(segs, &nr_segs, zero_buf,
+	    toc_entry->offset_address - entry_offset);
 
-	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (verbose)
+	if (verbose) {
 		log_dbgx("Metadata size: %zu bytes", buf_size);
-
-	xfwrite(buf, buf_size, fp, filename);
-
-	if (verbose)
 		log_dbgx("Payload size: %zu bytes", payload_size);
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
-
-		if (image == NULL)
-			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
-
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
 	}
 
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
-
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	/* Generate the FIP file. */
+	write_fip_file(filename, segs, nr_segs);
 
+	free(segs);
+	free(zero_buf);
 	free(buf);
-	fclose(fp);
 	return 0;
 }
 
@@ -596,7 +917,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -607,6 +928,166 @@ static void update_fip(void)
 	}
 }
 
+#ifndef _MSC_VER
+static void xpwrite(int fd, const void *buf, size_t size, off_t offset,
+    const char *filename)
+{
+	ssize_t ret;
+
+	while (size > 0) {
+		ret = pwrite(fd, buf, size, offset);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("Failed to write %s", filename);
+		}
+		buf = (const char *)buf + ret;
+		size -= ret;
+		offset += ret;
+	}
+}
+
+/*
+ * Return the space available in the parsed FIP to the image of `this`, i.e.
+ * up to the next image or the end of the file. Empty images may share
+ * their offset with the next one.
+ */
+static uint64_t image_slot_size(const image_desc_t *this)
+{
+	uint64_t offset = this->image->toc_e.offset_address;
+	uint64_t end = fip_size;
+	image_desc_t *desc;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		const image_t *image = desc->image;
+
+		if (desc == this || image == NULL)
+			continue;
+		if (image->toc_e.offset_address == offset &&
+		    image->toc_e.size == 0)
+			continue;
+		if (image->toc_e.offset_address >= offset &&
+		    image->toc_e.offset_address < end)
+			end = image->toc_e.offset_address;
+	}
+	return end - offset;
+}
+
+/*
+ * Try to replace the images in place in the FIP parsed from `filename`,
+ * which is only possible if each new image fits in the slot of the one it
+ * replaces and no image is added. Only the new images and the changed ToC
+ * entries are written. Returns 1 if the FIP was patched, 0 if it has to be
+ * repacked.
+ */
+static int patch_fip(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	const fip_toc_header_t *toc_header = (fip_toc_header_t *)fip_buf;
+	const fip_toc_entry_t *toc_entry;
+	char zero_buf[PAD_BUF_SIZE] = { 0 };
+	image_desc_t *desc;
+	int fd;
+
+	if (fip_buf == NULL)
+		return 0;
+
+	/* Check that every new image fits in place. */
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		struct BLD_PLAT_STAT st;
+		uint64_t offset;
+
+		if (desc->action != DO_PACK)
+			continue;
+
+		if (desc->image == NULL) {
+			if (verbose)
+				log_dbgx("Cannot patch in place: %s is a new image",
+				    desc->cmdline_name);
+			return 0;
+		}
+
+		if (stat(desc->action_arg, &st) == -1)
+			log_err("stat %s", desc->action_arg);
+
+		offset = desc->image->toc_e.offset_address;
+		if (offset % align != 0 ||
+		    (uint64_t)st.st_size > image_slot_size(desc)) {
+			if (verbose)
+				log_dbgx("Cannot patch in place: %s does not fit",
+				    desc->action_arg);
+			return 0;
+		}
+	}
+
+	fd = open(filename, O_RDWR);
+	if (fd == -1)
+		log_err("open %s", filename);
+
+	/* Overwrite the images and clear what is left of the old ones. */
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		uint64_t offset, old_size;
+		image_t *image;
+
+		if (desc->action != DO_PACK)
+			continue;
+
+		if (verbose)
+			log_dbgx("Patching %s with %s", desc->cmdline_name,
+			    desc->action_arg);
+
+		offset = desc->image->toc_e.offset_address;
+		old_size = desc->image->toc_e.size;
+
+		image = read_image_from_file(&desc->uuid, desc->action_arg);
+		image->toc_e.offset_address = offset;
+		xpwrite(fd, image->buffer, image->toc_e.size, offset, filename);
+		offset += image->toc_e.size;
+		while (old_size > image->toc_e.size) {
+			size_t len = old_size - image->toc_e.size;
+
+			if (len > sizeof(zero_buf))
+				len = sizeof(zero_buf);
+			xpwrite(fd, zero_buf, len, offset, filename);
+			offset += len;
+			old_size -= len;
+		}
+
+		free_image(desc->image);
+		desc->image = image;
+	}
+
+	/* Update the sizes in the matching ToC entries. */
+	for (toc_entry = (const fip_toc_entry_t *)(toc_header + 1);
+	     memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	     toc_entry++) {
+		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
+		if (desc == NULL || desc->action != DO_PACK ||
+		    desc->image->toc_e.size == toc_entry->size)
+			continue;
+		xpwrite(fd, &desc->image->toc_e, sizeof(desc->image->toc_e),
+		    (const char *)toc_entry - (const char *)fip_buf, filename);
+	}
+
+	if (toc_header->flags != toc_flags) {
+		fip_toc_header_t new_header = *toc_header;
+
+		new_header.flags = toc_flags;
+		xpwrite(fd, &new_header, sizeof(new_header), 0, filename);
+	}
+
+	if (close(fd) == -1)
+		log_err("close %s", filename);
+	return 1;
+}
+#else
+static int patch_fip(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	return 0;
+}
+#endif
+
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
 {
 	unsigned long long flags;
@@ -757,6 +1238,7 @@ static int update_cmd(int argc, char *argv[])
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
 	int pflag = 0;
+	int rflag = 0;
 
 	if (argc < 2)
 		update_usage();
@@ -767,12 +1249,13 @@ static int update_cmd(int argc, char *argv[])
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
+	opts = add_opt(opts, &nr_opts, "reuse", no_argument, 'r');
 	opts = add_opt(opts, &nr_opts, NULL, 0, 0);
 
 	while (1) {
 		int c, opt_index = 0;
 
-		c = getopt_long(argc, argv, "b:o:", opts, &opt_index);
+		c = getopt_long(argc, argv, "b:o:r", opts, &opt_index);
 		if (c == -1)
 			break;
 
@@ -816,6 +1299,9 @@ static int update_cmd(int argc, char *argv[])
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
+		case 'r':
+			rflag = 1;
+			break;
 		default:
 			update_usage();
 		}
@@ -837,6 +1323,14 @@ static int update_cmd(int argc, char *argv[])
 		toc_header.flags &= ~(0xffffULL << 32);
 	toc_flags = (toc_header.flags |= toc_flags);
 
+	/* Replace the images in place if asked to and if they fit. */
+	if (rflag) {
+		if (strcmp(outfile, argv[0]) == 0 &&
+		    patch_fip(outfile, toc_flags, align))
+			return 0;
+		log_warnx("Cannot update %s in place, repacking it", argv[0]);
+	}
+
 	update_fip();
 
 	pack_images(outfile, toc_flags, align);
@@ -854,6 +1348,7 @@ static void update_usage(void)
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
+	printf("  --reuse\t\t\tReplace the images in place when they fit, without repacking the FIP.\n");
 	printf("\n");
 	printf("Specific images are packed with the following options:\n");
 	for (; toc_entry->cmdline_name != NULL; toc_entry++)
@@ -862,12 +1357,27 @@ static void update_usage(void)
 	exit(1);
 }
 
+typedef struct unpack_job {
+	const image_t *image;
+	char           file[PATH_MAX];
+} unpack_job_t;
+
+static void unpack_image(void *arg)
+{
+	unpack_job_t *job = arg;
+
+	write_image_to_file(job->image, job->file);
+}
+
 static int unpack_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
 	size_t nr_opts = 0;
 	char outdir[PATH_MAX] = { 0 };
 	image_desc_t *desc;
+	unpack_job_t *jobs;
+	void **args;
+	size_t nr_jobs = 0;
 	int fflag = 0;
 	int unpack_all = 1;
 
@@ -942,9 +1452,14 @@ static int unpack_cmd(int argc, char *argv[])
 		if (chdir(outdir) == -1)
 			log_err("chdir %s", outdir);
 
-	/* Unpack all specified images. */
+	jobs = xzalloc(nr_image_descs * sizeof(*jobs),
+	    "failed to allocate memory for unpack jobs");
+	args = xzalloc(nr_image_descs * sizeof(*args),
+	    "failed to allocate memory for unpack jobs");
+
+	/* Collect all specified images. */
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		char file[PATH_MAX];
+		char *file = jobs[nr_jobs].file;
 		image_t *image = desc->image;
 
 		if (!unpack_all && desc->action != DO_UNPACK)
@@ -952,10 +1467,10 @@ static int unpack_cmd(int argc, char *argv[])
 
 		/* Build filename. */
 		if (desc->action_arg == NULL)
-			snprintf(file, sizeof(file), "%s.bin",
+			snprintf(file, PATH_MAX, "%s.bin",
 			    desc->cmdline_name);
 		else
-			snprintf(file, sizeof(file), "%s",
+			snprintf(file, PATH_MAX, "%s",
 			    desc->action_arg);
 
 		if (image == NULL) {
@@ -968,13 +1483,20 @@ static int unpack_cmd(int argc, char *argv[])
 		if (access(file, F_OK) != 0 || fflag) {
 			if (verbose)
 				log_dbgx("Unpacking %s", file);
-			write_image_to_file(image, file);
+			jobs[nr_jobs].image = image;
+			args[nr_jobs] = &jobs[nr_jobs];
+			nr_jobs++;
 		} else {
 			log_warnx("File %s already exists, use --force to overwrite it",
 			    file);
 		}
 	}
 
+	/* Write the images out in parallel. */
+	run_parallel(unpack_image, args, nr_jobs);
+
+	free(args);
+	free(jobs);
 	return 0;
 }
 
@@ -1090,7 +1612,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1218,5 +1740,6 @@ int main(int argc, char *argv[])
 	if (i == NELEM(cmds))
 		usage();
 	free_image_descs();
+	release_fip();
 	return ret;
 }
@@ -40,11 +40,25 @@ typedef struct image_desc {
 	struct image_desc *next;
 } image_desc_t;
 
+/* How the buffer of an image was obtained, and so how to release it. */
+enum {
+	BUF_BORROWED = 0,	/* Points into the FIP being processed */
+	BUF_MALLOC   = 1,
+	BUF_MMAP     = 2
+};
+
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	int                  buffer_type;
 } image_t;
 
+/* Piece of the FIP file being written. */
+typedef struct out_seg {
+	const void          *buf;
+	size_t               len;
+} out_seg_t;
+
 typedef struct cmd {
 	char              *name;
 	int              (*handler)(int, char **);
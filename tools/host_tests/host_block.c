@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <fcntl.h>
+#include <io_block.h>
+#include <io_driver.h>
+#include <io_storage.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "host_tests.h"
+
+/*
+ * File backed block device for io_block. Only one file can be used at a
+ * time, like a platform usually has a single boot device.
+ */
+
+static int block_fd = -1;
+static size_t block_size;
+
+static size_t host_block_read(int lba, uintptr_t buf, size_t size)
+{
+	ssize_t ret;
+
+	assert((size % block_size) == 0U);
+
+	ret = pread(block_fd, (void *)buf, size, (off_t)lba * block_size);
+
+	return (ret < 0) ? 0U : (size_t)ret;
+}
+
+static size_t host_block_write(int lba, const uintptr_t buf, size_t size)
+{
+	ssize_t ret;
+
+	assert((size % block_size) == 0U);
+
+	ret = pwrite(block_fd, (const void *)buf, size,
+		     (off_t)lba * block_size);
+
+	return (ret < 0) ? 0U : (size_t)ret;
+}
+
+/*
+ * Device specification given to io_dev_open() for the block device. The
+ * bounce buffer takes several blocks so that io_block can read them at once,
+ * and is aligned for block sizes up to 4KB.
+ */
+static uint8_t block_buffer[64 * 1024] __aligned(4096);
+
+io_block_dev_spec_t host_block_dev_spec = {
+	.ops = {
+		.read = host_block_read,
+		.write = host_block_write,
+	},
+};
+
+/* Back the block device with the file at `path` */
+int host_block_open(const char *path, size_t bsize)
+{
+	assert(block_fd < 0);
+
+	block_fd = open(path, O_RDWR);
+	if (block_fd < 0) {
+		perror(path);
+		return -1;
+	}
+
+	block_size = bsize;
+	host_block_dev_spec.buffer.offset = (uintptr_t)block_buffer;
+	host_block_dev_spec.buffer.length = sizeof(block_buffer);
+	host_block_dev_spec.block_size = bsize;
+
+	return 0;
+}
+
+/* Open the io_block device backed by the current file */
+int host_block_dev_open(uintptr_t *dev_handle)
+{
+	static const io_dev_connector_t *block_dev_con;
+
+	assert(block_fd >= 0);
+
+	if ((block_dev_con == NULL) &&
+	    (register_io_dev_block(&block_dev_con) != 0))
+		return -1;
+
+	return io_dev_open(block_dev_con, (uintptr_t)&host_block_dev_spec,
+			   dev_handle);
+}
+
+void host_block_close(void)
+{
+	if (block_fd >= 0) {
+		close(block_fd);
+		block_fd = -1;
+	}
+}
+
+/* Write `len` bytes of `data` to a new temporary file, whose name is returned */
+int host_tmp_file(const void *data, size_t len, char *path, size_t path_len)
+{
+	int fd;
+
+	snprintf(path, path_len, "%s/host_tests.XXXXXX",
+		 (getenv("TMPDIR") != NULL) ? getenv("TMPDIR") : "/tmp");
+
+	fd = mkstemp(path);
+	if (fd < 0) {
+		perror("mkstemp");
+		return -1;
+	}
+
+	if (write(fd, data, len) != (ssize_t)len) {
+		perror(path);
+		close(fd);
+		unlink(path);
+		return -1;
+	}
+
+	close(fd);
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utils.h>
+#include <xlat_tables_v2.h>
+
+#include "host_tests.h"
+
+/*
+ * Platform layer of the host build: the debug and platform hooks called by
+ * the firmware modules, and the architecture specific part of the translation
+ * tables library.
+ */
+
+static struct {
+	uintptr_t dev_handle;
+	uintptr_t image_spec;
+} image_sources[HOST_MAX_IMAGE_ID];
+
+void tf_log(const char *fmt, ...)
+{
+	va_list args;
+
+	/* The first character is the log level marker */
+	va_start(args, fmt);
+	vprintf(fmt + 1, args);
+	va_end(args);
+}
+
+void tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+void __dead2 do_panic(void)
+{
+	fprintf(stderr, "PANIC\n");
+	abort();
+}
+
+void host_set_image_source(unsigned int image_id, uintptr_t dev_handle,
+			   uintptr_t image_spec)
+{
+	assert(image_id < HOST_MAX_IMAGE_ID);
+
+	image_sources[image_id].dev_handle = dev_handle;
+	image_sources[image_id].image_spec = image_spec;
+}
+
+int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			  uintptr_t *image_spec)
+{
+	if ((image_id >= HOST_MAX_IMAGE_ID) ||
+	    (image_sources[image_id].dev_handle == 0))
+		return -1;
+
+	*dev_handle = image_sources[image_id].dev_handle;
+	*image_spec = image_sources[image_id].image_spec;
+
+	return 0;
+}
+
+/* The AArch64 version is written in assembly */
+void zeromem(void *mem, u_register_t length)
+{
+	memset(mem, 0, length);
+}
+
+/* The tables are only built, never used by an MMU */
+void xlat_arch_tlbi_va(uintptr_t va)
+{
+}
+
+void xlat_arch_tlbi_va_regime(uintptr_t va, xlat_regime_t xlat_regime)
+{
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+}
+
+int xlat_arch_current_el(void)
+{
+	return 3;
+}
+
+unsigned long long xlat_arch_get_max_supported_pa(void)
+{
+	/* 48-bit physical addresses */
+	return (1ULL << 48) - 1ULL;
+}
+
+int is_mmu_enabled_ctx(const xlat_ctx_t *ctx)
+{
+	return 0;
+}
+
+void enable_mmu_arch(unsigned int flags, uint64_t *base_table,
+		     unsigned long long max_pa, uintptr_t max_va)
+{
+	panic();
+}
+
+uint64_t host_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+/* Report the throughput of `ops` operations on `bytes` bytes in `ns` */
+void bench_report(const char *name, size_t bytes, unsigned int ops,
+		  uint64_t ns)
+{
+	if (ns == 0)
+		ns = 1;
+
+	printf("  %-36s %10.1f ns/op", name, (double)ns / ops);
+	if (bytes != 0)
+		printf(" %10.1f MB/s", ((double)bytes * 1000.0) / ns);
+	printf("\n");
+}
+
+/* Fill `buf` with reproducible pseudo-random data */
+void host_fill_random(void *buf, size_t len, uint32_t seed)
+{
+	uint8_t *p = buf;
+	uint32_t x = (seed != 0U) ? seed : 1U;
+
+	while (len-- != 0U) {
+		/* xorshift32 */
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		*p++ = (uint8_t)x;
+	}
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "host_tests.h"
+
+/*
+ * Runs the firmware library modules built for the host: their tests, and
+ * their benchmarks when asked to.
+ */
+
+static const host_test_t *const tests[] = {
+	&test_mem,
+	&test_io_fip,
+	&test_io_block,
+	&test_partition,
+	&test_fdt,
+	&test_gunzip,
+	&test_xlat,
+};
+
+#define NUM_TESTS	(sizeof(tests) / sizeof(tests[0]))
+
+static void usage(const char *name)
+{
+	unsigned int i;
+
+	printf("usage: %s [-b] [test...]\n\n", name);
+	printf("  -b  Also run the benchmarks\n\n");
+	printf("Tests:");
+	for (i = 0; i < NUM_TESTS; i++)
+		printf(" %s", tests[i]->name);
+	printf("\n");
+}
+
+static int selected(const char *name, int argc, char *argv[])
+{
+	int i;
+
+	if (argc == 0)
+		return 1;
+
+	for (i = 0; i < argc; i++) {
+		if (strcmp(name, argv[i]) == 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int i, run = 0, failed = 0;
+	int opt, bench = 0;
+
+	while ((opt = getopt(argc, argv, "bh")) != -1) {
+		switch (opt) {
+		case 'b':
+			bench = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return (opt == 'h') ? 0 : 1;
+		}
+	}
+	argc -= optind;
+	argv += optind;
+
+	for (i = 0; i < NUM_TESTS; i++) {
+		if (!selected(tests[i]->name, argc, argv))
+			continue;
+
+		printf("%-12s ", tests[i]->name);
+		fflush(stdout);
+		run++;
+		if (tests[i]->run() != 0) {
+			printf("FAIL\n");
+			failed++;
+			continue;
+		}
+		printf("ok\n");
+
+		if (bench && (tests[i]->bench != NULL))
+			tests[i]->bench();
+	}
+
+	if (run == 0) {
+		usage(argv[-optind]);
+		return 1;
+	}
+
+	printf("%u of %u tests passed\n", run - failed, run);
+
+	return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __HOST_TESTS_H__
+#define __HOST_TESTS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Fail the current test if `cond` does not hold */
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			printf("  %s:%d: check failed: %s\n",		\
+			       __FILE__, __LINE__, #cond);		\
+			return -1;					\
+		}							\
+	} while (0)
+
+/*
+ * A test case. run() returns 0 on success. bench(), which may be NULL, runs
+ * the benchmarks of the module and reports them with bench_report().
+ */
+typedef struct host_test {
+	const char *name;
+	int (*run)(void);
+	void (*bench)(void);
+} host_test_t;
+
+/* Image IDs given to plat_get_image_source() by the tests */
+#define HOST_FIP_IMAGE_ID	0
+#define HOST_GPT_IMAGE_ID	1
+#define HOST_MAX_IMAGE_ID	2
+
+/* host_plat.c */
+void host_set_image_source(unsigned int image_id, uintptr_t dev_handle,
+			   uintptr_t image_spec);
+uint64_t host_time_ns(void);
+void bench_report(const char *name, size_t bytes, unsigned int ops,
+		  uint64_t ns);
+void host_fill_random(void *buf, size_t len, uint32_t seed);
+
+/* host_block.c */
+struct io_block_dev_spec;
+extern struct io_block_dev_spec host_block_dev_spec;
+int host_block_open(const char *path, size_t block_size);
+int host_block_dev_open(uintptr_t *dev_handle);
+void host_block_close(void);
+int host_tmp_file(const void *data, size_t len, char *path, size_t path_len);
+
+/* Test cases */
+extern const host_test_t test_mem;
+extern const host_test_t test_io_fip;
+extern const host_test_t test_io_block;
+extern const host_test_t test_partition;
+extern const host_test_t test_fdt;
+extern const host_test_t test_gunzip;
+extern const host_test_t test_xlat;
+
+#endif /* __HOST_TESTS_H__ */
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+#include <types.h>
+
+/*
+ * Barriers and cache maintenance have no effect on the host, where the
+ * translation tables are built but never used by an MMU.
+ */
+static inline void dsb(void) {}
+static inline void dsbish(void) {}
+static inline void dsbishst(void) {}
+static inline void isb(void) {}
+
+static inline void flush_dcache_range(uintptr_t addr, size_t size) {}
+static inline void inv_dcache_range(uintptr_t addr, size_t size) {}
+
+#endif /* __ARCH_HELPERS_H__ */
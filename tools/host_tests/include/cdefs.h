@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __HOST_CDEFS_H__
+#define __HOST_CDEFS_H__
+
+/*
+ * Attributes which the firmware gets from its own sys/cdefs.h. This header is
+ * included first in every file of the host build.
+ */
+#define __dead2		__attribute__((__noreturn__))
+#define __deprecated	__attribute__((__deprecated__))
+#define __packed	__attribute__((__packed__))
+#define __used		__attribute__((__used__))
+#define __unused	__attribute__((__unused__))
+#define __aligned(x)	__attribute__((__aligned__(x)))
+#define __section(x)	__attribute__((__section__(x)))
+#define __printflike(fmtarg, firstvararg)				\
+		__attribute__((__format__ (__printf__, fmtarg, firstvararg)))
+
+#endif /* __HOST_CDEFS_H__ */
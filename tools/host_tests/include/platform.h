@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __PLATFORM_H__
+#define __PLATFORM_H__
+
+#include <stdint.h>
+
+/* Platform hooks used by the modules of the host build, see host_plat.c */
+int plat_get_image_source(unsigned int image_id,
+			  uintptr_t *dev_handle,
+			  uintptr_t *image_spec);
+
+#endif /* __PLATFORM_H__ */
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __PLATFORM_DEF_H__
+#define __PLATFORM_DEF_H__
+
+/* Platform definitions of the host build */
+
+/* IO storage: a memmap, a block and a FIP device */
+#define MAX_IO_DEVICES			4
+#define MAX_IO_HANDLES			8
+#define MAX_IO_BLOCK_DEVICES		1
+
+/* Translation tables of the default context, the tests use their own */
+#define PLAT_VIRT_ADDR_SPACE_SIZE	(1ULL << 32)
+#define PLAT_PHY_ADDR_SPACE_SIZE	(1ULL << 32)
+#define MAX_MMAP_REGIONS		8
+#define MAX_XLAT_TABLES			4
+
+#define CACHE_WRITEBACK_GRANULE		64
+
+#endif /* __PLATFORM_DEF_H__ */
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __HOST_TYPES_H__
+#define __HOST_TYPES_H__
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* The host build is only supported on 64-bit hosts, like AArch64 */
+typedef uint64_t u_register_t;
+
+#endif /* __HOST_TYPES_H__ */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <libfdt.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_tests.h"
+
+/*
+ * Tests of libfdt on a DTB laid out like a dynamic configuration: a few
+ * nodes with several properties each.
+ */
+
+#define DTB_SIZE		(16 * 1024)
+#define DTB_NODES		16
+
+static uint8_t dtb[DTB_SIZE];
+
+static int build_dtb(void)
+{
+	unsigned int i;
+	char name[32];
+	uint32_t val;
+
+	if ((fdt_create(dtb, DTB_SIZE) != 0) ||
+	    (fdt_finish_reservemap(dtb) != 0) ||
+	    (fdt_begin_node(dtb, "") != 0) ||
+	    (fdt_property_string(dtb, "compatible", "arm,tb_fw") != 0))
+		return -1;
+
+	for (i = 0; i < DTB_NODES; i++) {
+		snprintf(name, sizeof(name), "node%u", i);
+		val = cpu_to_fdt32(i);
+		if ((fdt_begin_node(dtb, name) != 0) ||
+		    (fdt_property_string(dtb, "compatible", name) != 0) ||
+		    (fdt_property(dtb, "addr", &val, sizeof(val)) != 0) ||
+		    (fdt_property_u32(dtb, "size", i * 4096) != 0) ||
+		    (fdt_property_u64(dtb, "base", (uint64_t)i << 32) != 0) ||
+		    (fdt_end_node(dtb) != 0))
+			return -1;
+	}
+
+	if ((fdt_end_node(dtb) != 0) || (fdt_finish(dtb) != 0))
+		return -1;
+
+	/* Make room for the properties added by the tests */
+	return fdt_open_into(dtb, dtb, DTB_SIZE);
+}
+
+static int fdt_run(void)
+{
+	const fdt32_t *prop;
+	const fdt64_t *prop64;
+	unsigned int i;
+	char path[32];
+	int node, len;
+
+	CHECK(build_dtb() == 0);
+	CHECK(fdt_check_header(dtb) == 0);
+	CHECK(fdt_node_check_compatible(dtb, 0, "arm,tb_fw") == 0);
+
+	for (i = 0; i < DTB_NODES; i++) {
+		snprintf(path, sizeof(path), "/node%u", i);
+		node = fdt_path_offset(dtb, path);
+		CHECK(node >= 0);
+		CHECK(fdt_node_offset_by_compatible(dtb, -1, path + 1) == node);
+
+		prop = fdt_getprop(dtb, node, "addr", &len);
+		CHECK((prop != NULL) && (len == sizeof(*prop)));
+		CHECK(fdt32_to_cpu(*prop) == i);
+		prop = fdt_getprop(dtb, node, "size", &len);
+		CHECK((prop != NULL) && (fdt32_to_cpu(*prop) == i * 4096));
+		prop64 = fdt_getprop(dtb, node, "base", &len);
+		CHECK((prop64 != NULL) && (len == sizeof(*prop64)));
+		CHECK(fdt64_to_cpu(*prop64) == ((uint64_t)i << 32));
+		CHECK(fdt_getprop(dtb, node, "missing", &len) == NULL);
+		CHECK(len == -FDT_ERR_NOTFOUND);
+	}
+	CHECK(fdt_path_offset(dtb, "/node99") == -FDT_ERR_NOTFOUND);
+
+	/* In place and resizing updates */
+	node = fdt_path_offset(dtb, "/node3");
+	CHECK(fdt_setprop_inplace_u32(dtb, node, "size", 0x1234) == 0);
+	prop = fdt_getprop(dtb, node, "size", &len);
+	CHECK((prop != NULL) && (fdt32_to_cpu(*prop) == 0x1234));
+
+	CHECK(fdt_setprop_string(dtb, node, "compatible", "a,longer-name") == 0);
+	node = fdt_path_offset(dtb, "/node4");
+	CHECK(fdt_node_check_compatible(dtb, node, "node4") == 0);
+	prop = fdt_getprop(dtb, node, "addr", &len);
+	CHECK((prop != NULL) && (fdt32_to_cpu(*prop) == 4));
+
+	CHECK(fdt_delprop(dtb, node, "addr") == 0);
+	CHECK(fdt_getprop(dtb, node, "addr", &len) == NULL);
+	CHECK(fdt_check_header(dtb) == 0);
+
+	return 0;
+}
+
+static void fdt_bench(void)
+{
+	unsigned int i, n = 200000;
+	char paths[DTB_NODES][32];
+	const char *path;
+	uint64_t t;
+	int node, len;
+
+	if (build_dtb() != 0)
+		return;
+
+	for (i = 0; i < DTB_NODES; i++)
+		snprintf(paths[i], sizeof(paths[i]), "/node%u", i);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		path = paths[i % DTB_NODES];
+		node = fdt_path_offset(dtb, path);
+		fdt_getprop(dtb, node, "base", &len);
+	}
+	bench_report("DTB node lookup and getprop", 0, n, host_time_ns() - t);
+
+	node = fdt_path_offset(dtb, "/node15");
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		fdt_getprop(dtb, node, (i & 1) ? "base" : "addr", &len);
+	bench_report("DTB getprop in a known node", 0, n, host_time_ns() - t);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		fdt_node_offset_by_compatible(dtb, -1, "node15");
+	bench_report("DTB lookup by compatible", 0, n, host_time_ns() - t);
+}
+
+const host_test_t test_fdt = {
+	.name = "fdt",
+	.run = fdt_run,
+	.bench = fdt_bench,
+};
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <tf_gunzip.h>
+#include <unistd.h>
+
+#include "host_tests.h"
+
+/*
+ * Tests of tf_gunzip on data compressed by the host gzip, as done for the
+ * images of the build.
+ */
+
+#define GZ_DATA_SIZE		(1024 * 1024)
+#define GZ_WORK_SIZE		(64 * 1024)
+
+static uint8_t *data, *gz, *out;
+static uint8_t work[GZ_WORK_SIZE];
+static size_t gz_len;
+
+/* Compressible firmware-like data: random runs mixed with repeated ones */
+static void fill_data(uint8_t *buf, size_t len)
+{
+	size_t off, run;
+
+	host_fill_random(buf, len, 5);
+	for (off = 0; off < len; off += 4096) {
+		run = len - off;
+		if (run > 3000)
+			run = 3000;
+		if (off >= 8192)
+			memcpy(buf + off, buf + off - 8192 + 17, run);
+	}
+}
+
+/* Compress `data` with the host gzip */
+static int gz_setup(void)
+{
+	char path[256], cmd[300];
+	FILE *f;
+
+	if (gz != NULL)
+		return 0;
+
+	data = malloc(GZ_DATA_SIZE);
+	out = malloc(GZ_DATA_SIZE);
+	gz = malloc(2 * GZ_DATA_SIZE);
+	if ((data == NULL) || (out == NULL) || (gz == NULL))
+		return -1;
+
+	fill_data(data, GZ_DATA_SIZE);
+	if (host_tmp_file(data, GZ_DATA_SIZE, path, sizeof(path)) != 0)
+		return -1;
+
+	snprintf(cmd, sizeof(cmd), "gzip -c -n -9 < %s", path);
+	f = popen(cmd, "r");
+	if (f != NULL) {
+		gz_len = fread(gz, 1, 2 * GZ_DATA_SIZE, f);
+		if (pclose(f) != 0)
+			gz_len = 0;
+	}
+	unlink(path);
+
+	if (gz_len == 0) {
+		printf("  cannot run gzip\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int do_gunzip(size_t in_len, size_t out_len, size_t *len)
+{
+	uintptr_t in_buf = (uintptr_t)gz, out_buf = (uintptr_t)out;
+	int ret;
+
+	ret = gunzip(&in_buf, in_len, &out_buf, out_len, (uintptr_t)work,
+		     sizeof(work));
+	*len = out_buf - (uintptr_t)out;
+
+	return ret;
+}
+
+static int gunzip_run(void)
+{
+	size_t len;
+
+	CHECK(gz_setup() == 0);
+
+	memset(out, 0, GZ_DATA_SIZE);
+	CHECK(do_gunzip(gz_len, GZ_DATA_SIZE, &len) == 0);
+	CHECK(len == GZ_DATA_SIZE);
+	CHECK(memcmp(out, data, GZ_DATA_SIZE) == 0);
+
+	/* Truncated input, output buffer too small, corrupted data */
+	CHECK(do_gunzip(gz_len / 2, GZ_DATA_SIZE, &len) != 0);
+	CHECK(do_gunzip(gz_len, GZ_DATA_SIZE - 1, &len) != 0);
+	gz[gz_len / 2] ^= 0x55;
+	CHECK(do_gunzip(gz_len, GZ_DATA_SIZE, &len) != 0);
+	gz[gz_len / 2] ^= 0x55;
+
+	return 0;
+}
+
+static void gunzip_bench(void)
+{
+	unsigned int i, n = 20;
+	size_t len;
+	uint64_t t;
+
+	if (gz_setup() != 0)
+		return;
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		do_gunzip(gz_len, GZ_DATA_SIZE, &len);
+	bench_report("gunzip 1MB", GZ_DATA_SIZE * n, n, host_time_ns() - t);
+}
+
+const host_test_t test_gunzip = {
+	.name = "gunzip",
+	.run = gunzip_run,
+	.bench = gunzip_bench,
+};
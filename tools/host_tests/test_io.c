@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <firmware_image_package.h>
+#include <io_block.h>
+#include <io_driver.h>
+#include <io_fip.h>
+#include <io_memmap.h>
+#include <io_storage.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <utils_def.h>
+
+#include "host_tests.h"
+
+/*
+ * Tests of the FIP driver over io_memmap, and of io_block over a file backed
+ * block device.
+ */
+
+#define FIP_NUM_IMAGES		3
+#define FIP_IMAGE_SIZE		(256 * 1024)
+#define FIP_DATA_OFFSET		1024
+#define FIP_SIZE		(FIP_DATA_OFFSET + \
+				 (FIP_NUM_IMAGES * FIP_IMAGE_SIZE))
+
+#define BLOCK_SIZE		512
+#define BLOCK_DEV_SIZE		(4 * 1024 * 1024)
+
+static const io_uuid_spec_t fip_images[FIP_NUM_IMAGES] = {
+	{ .uuid = UUID_TRUSTED_BOOT_FIRMWARE_BL2 },
+	{ .uuid = UUID_EL3_RUNTIME_FIRMWARE_BL31 },
+	{ .uuid = UUID_NON_TRUSTED_FIRMWARE_BL33 },
+};
+
+static const io_uuid_spec_t fip_missing_image = {
+	.uuid = UUID_SECURE_PAYLOAD_BL32,
+};
+
+static uint8_t *fip;
+static io_block_spec_t fip_block_spec;
+static uintptr_t fip_dev_handle;
+
+/* Build a FIP in memory and open the FIP device on it */
+static int fip_setup(void)
+{
+	static const io_dev_connector_t *memmap_dev_con, *fip_dev_con;
+	static uintptr_t memmap_dev_handle;
+	fip_toc_header_t *header;
+	fip_toc_entry_t *entry;
+	unsigned int i;
+
+	if (fip != NULL)
+		return 0;
+
+	if ((register_io_dev_memmap(&memmap_dev_con) != 0) ||
+	    (register_io_dev_fip(&fip_dev_con) != 0) ||
+	    (io_dev_open(memmap_dev_con, (uintptr_t)NULL,
+			 &memmap_dev_handle) != 0) ||
+	    (io_dev_open(fip_dev_con, (uintptr_t)NULL, &fip_dev_handle) != 0))
+		return -1;
+
+	fip = calloc(1, FIP_SIZE);
+	if (fip == NULL)
+		return -1;
+
+	header = (fip_toc_header_t *)fip;
+	header->name = TOC_HEADER_NAME;
+	header->serial_number = 1;
+
+	entry = (fip_toc_entry_t *)(header + 1);
+	for (i = 0; i < FIP_NUM_IMAGES; i++, entry++) {
+		memcpy(&entry->uuid, &fip_images[i].uuid, sizeof(uuid_t));
+		entry->offset_address = FIP_DATA_OFFSET + (i * FIP_IMAGE_SIZE);
+		entry->size = FIP_IMAGE_SIZE - i;
+		host_fill_random(fip + entry->offset_address, entry->size,
+				 i + 1);
+	}
+	/* The null entry ending the table of contents is already cleared */
+
+	fip_block_spec.offset = (uintptr_t)fip;
+	fip_block_spec.length = FIP_SIZE;
+	host_set_image_source(HOST_FIP_IMAGE_ID, memmap_dev_handle,
+			      (uintptr_t)&fip_block_spec);
+
+	return io_dev_init(fip_dev_handle, HOST_FIP_IMAGE_ID);
+}
+
+static int io_fip_run(void)
+{
+	uintptr_t handle[2];
+	size_t size, bytes_read, off;
+	uint8_t *buf;
+	unsigned int i;
+	int ret = -1;
+
+	CHECK(fip_setup() == 0);
+
+	buf = malloc(FIP_IMAGE_SIZE);
+	CHECK(buf != NULL);
+
+	for (i = 0; i < FIP_NUM_IMAGES; i++) {
+		off = FIP_DATA_OFFSET + (i * FIP_IMAGE_SIZE);
+		if ((io_open(fip_dev_handle, (uintptr_t)&fip_images[i],
+			     &handle[0]) != 0) ||
+		    (io_size(handle[0], &size) != 0) ||
+		    (size != (FIP_IMAGE_SIZE - i)) ||
+		    (io_read(handle[0], (uintptr_t)buf, size,
+			     &bytes_read) != 0) ||
+		    (bytes_read != size) ||
+		    (memcmp(buf, fip + off, size) != 0)) {
+			printf("  image %u read failed\n", i);
+			goto out;
+		}
+		io_close(handle[0]);
+	}
+
+	/* Interleaved reads of two files open at the same time */
+	if ((io_open(fip_dev_handle, (uintptr_t)&fip_images[0],
+		     &handle[0]) != 0) ||
+	    (io_open(fip_dev_handle, (uintptr_t)&fip_images[2],
+		     &handle[1]) != 0)) {
+		printf("  cannot open two images at once\n");
+		goto out;
+	}
+	for (off = 0; off < 4096; off += 1024) {
+		for (i = 0; i < 2; i++) {
+			if ((io_read(handle[i], (uintptr_t)buf, 1024,
+				     &bytes_read) != 0) ||
+			    (bytes_read != 1024) ||
+			    (memcmp(buf, fip + FIP_DATA_OFFSET +
+				    (2 * i * FIP_IMAGE_SIZE) + off,
+				    1024) != 0)) {
+				printf("  interleaved read failed\n");
+				io_close(handle[0]);
+				io_close(handle[1]);
+				goto out;
+			}
+		}
+	}
+	io_close(handle[0]);
+	io_close(handle[1]);
+
+	if (io_open(fip_dev_handle, (uintptr_t)&fip_missing_image,
+		    &handle[0]) == 0) {
+		printf("  missing image found\n");
+		io_close(handle[0]);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	free(buf);
+	return ret;
+}
+
+static void io_fip_bench(void)
+{
+	uintptr_t handle;
+	size_t bytes_read;
+	uint8_t *buf;
+	unsigned int i, n = 1000;
+	uint64_t t;
+
+	buf = malloc(FIP_IMAGE_SIZE);
+	if ((buf == NULL) || (fip_setup() != 0))
+		goto out;
+
+	/* Look up of the last image of the table of contents */
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		if (io_open(fip_dev_handle, (uintptr_t)&fip_images[2],
+			    &handle) != 0)
+			goto out;
+		io_close(handle);
+	}
+	bench_report("FIP open, third entry", 0, n, host_time_ns() - t);
+
+	n = 200;
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		if (io_open(fip_dev_handle, (uintptr_t)&fip_images[0],
+			    &handle) != 0)
+			goto out;
+		io_read(handle, (uintptr_t)buf, FIP_IMAGE_SIZE, &bytes_read);
+		io_close(handle);
+	}
+	bench_report("FIP open and read 256KB", FIP_IMAGE_SIZE * n, n,
+		     host_time_ns() - t);
+out:
+	free(buf);
+}
+
+const host_test_t test_io_fip = {
+	.name = "io_fip",
+	.run = io_fip_run,
+	.bench = io_fip_bench,
+};
+
+static uint8_t *block_data;
+static char block_path[256];
+
+/* Create the file backing the block device and open the device */
+static int block_setup(uintptr_t *dev_handle)
+{
+	if (block_data == NULL) {
+		block_data = malloc(BLOCK_DEV_SIZE);
+		if (block_data == NULL)
+			return -1;
+		host_fill_random(block_data, BLOCK_DEV_SIZE, 7);
+	}
+
+	if ((host_tmp_file(block_data, BLOCK_DEV_SIZE, block_path,
+			   sizeof(block_path)) != 0) ||
+	    (host_block_open(block_path, BLOCK_SIZE) != 0))
+		return -1;
+
+	return host_block_dev_open(dev_handle);
+}
+
+static void block_teardown(uintptr_t dev_handle)
+{
+	io_dev_close(dev_handle);
+	host_block_close();
+	unlink(block_path);
+}
+
+static int io_block_check(uintptr_t dev_handle, size_t region_off,
+			  size_t off, size_t len, uint8_t *buf)
+{
+	io_block_spec_t region = {
+		.offset = region_off,
+		.length = BLOCK_DEV_SIZE - region_off,
+	};
+	uintptr_t handle;
+	size_t bytes_read;
+	int ret = -1;
+
+	if (io_open(dev_handle, (uintptr_t)&region, &handle) != 0)
+		return -1;
+
+	memset(buf, 0, len);
+	if ((io_seek(handle, IO_SEEK_SET, off) == 0) &&
+	    (io_read(handle, (uintptr_t)buf, len, &bytes_read) == 0) &&
+	    (bytes_read == len) &&
+	    (memcmp(buf, block_data + region_off + off, len) == 0))
+		ret = 0;
+
+	io_close(handle);
+
+	if (ret != 0)
+		printf("  read failed, region %zu offset %zu length %zu\n",
+		       region_off, off, len);
+	return ret;
+}
+
+static int io_block_run(void)
+{
+	static const size_t lengths[] = {
+		1, 511, 512, 513, 4096, 65535, 65536, 65537, 300000,
+	};
+	static const size_t offsets[] = { 0, 1, 511, 512, 4097, 100000 };
+	uintptr_t dev_handle;
+	unsigned int i, j;
+	uint8_t *buf;
+	int ret = -1;
+
+	CHECK(block_setup(&dev_handle) == 0);
+
+	buf = malloc(BLOCK_DEV_SIZE);
+	if (buf == NULL)
+		goto out;
+
+	for (i = 0; i < ARRAY_SIZE(offsets); i++) {
+		for (j = 0; j < ARRAY_SIZE(lengths); j++) {
+			if ((io_block_check(dev_handle, 0, offsets[i],
+					    lengths[j], buf) != 0) ||
+			    (io_block_check(dev_handle, 8 * BLOCK_SIZE,
+					    offsets[i], lengths[j], buf) != 0))
+				goto out;
+		}
+	}
+
+	ret = 0;
+out:
+	free(buf);
+	block_teardown(dev_handle);
+	return ret;
+}
+
+static void io_block_bench(void)
+{
+	io_block_spec_t region = {
+		.offset = 0,
+		.length = BLOCK_DEV_SIZE,
+	};
+	uintptr_t dev_handle, handle;
+	size_t bytes_read;
+	unsigned int i, n = 20;
+	uint8_t *buf;
+	uint64_t t;
+
+	if (block_setup(&dev_handle) != 0)
+		return;
+
+	buf = malloc(BLOCK_DEV_SIZE);
+	if (buf == NULL)
+		goto out;
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		if (io_open(dev_handle, (uintptr_t)&region, &handle) != 0)
+			goto out;
+		io_read(handle, (uintptr_t)buf, BLOCK_DEV_SIZE, &bytes_read);
+		io_close(handle);
+	}
+	bench_report("block read 4MB, aligned", BLOCK_DEV_SIZE * n, n,
+		     host_time_ns() - t);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		if (io_open(dev_handle, (uintptr_t)&region, &handle) != 0)
+			goto out;
+		io_seek(handle, IO_SEEK_SET, 3);
+		io_read(handle, (uintptr_t)buf, BLOCK_DEV_SIZE - 1024,
+			&bytes_read);
+		io_close(handle);
+	}
+	bench_report("block read 4MB, unaligned", (BLOCK_DEV_SIZE - 1024) * n,
+		     n, host_time_ns() - t);
+out:
+	free(buf);
+	block_teardown(dev_handle);
+}
+
+const host_test_t test_io_block = {
+	.name = "io_block",
+	.run = io_block_run,
+	.bench = io_block_bench,
+};
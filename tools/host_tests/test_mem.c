@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_tests.h"
+
+/*
+ * The memory functions of the firmware libc (lib/stdlib/mem.c) are built
+ * with a tf_ prefix, so that they do not replace the ones of the host.
+ */
+void *tf_memcpy(void *dst, const void *src, size_t len);
+void *tf_memmove(void *dst, const void *src, size_t len);
+void *tf_memset(void *dst, int val, size_t count);
+int tf_memcmp(const void *s1, const void *s2, size_t len);
+
+#define MEM_TEST_SIZE		4096
+#define MEM_BENCH_SIZE		(1024 * 1024)
+
+static int mem_run(void)
+{
+	uint8_t *src, *dst, *ref;
+	size_t off, len;
+	int ret = -1;
+
+	src = malloc(MEM_TEST_SIZE);
+	dst = malloc(MEM_TEST_SIZE);
+	ref = malloc(MEM_TEST_SIZE);
+	if ((src == NULL) || (dst == NULL) || (ref == NULL))
+		goto out;
+
+	host_fill_random(src, MEM_TEST_SIZE, 1);
+
+	/* Every alignment and a few lengths, guarding the bytes around */
+	for (off = 0; off < 16; off++) {
+		for (len = 0; len < 300; len += 7) {
+			memset(dst, 0xa5, MEM_TEST_SIZE);
+			memset(ref, 0xa5, MEM_TEST_SIZE);
+			memcpy(ref + off, src + (15 - off), len);
+			if ((tf_memcpy(dst + off, src + (15 - off), len) !=
+			     dst + off) ||
+			    (memcmp(dst, ref, MEM_TEST_SIZE) != 0)) {
+				printf("  memcpy failed, offset %zu len %zu\n",
+				       off, len);
+				goto out;
+			}
+		}
+	}
+
+	/* Overlapping moves in both directions */
+	memcpy(dst, src, MEM_TEST_SIZE);
+	memcpy(ref, src, MEM_TEST_SIZE);
+	tf_memmove(dst + 3, dst, 1000);
+	memmove(ref + 3, ref, 1000);
+	tf_memmove(dst + 100, dst + 117, 1000);
+	memmove(ref + 100, ref + 117, 1000);
+	if (memcmp(dst, ref, MEM_TEST_SIZE) != 0) {
+		printf("  memmove failed\n");
+		goto out;
+	}
+
+	tf_memset(dst + 5, 0x3c, 100);
+	memset(ref + 5, 0x3c, 100);
+	if ((tf_memcmp(dst, ref, MEM_TEST_SIZE) != 0) ||
+	    (tf_memcmp(src, dst, MEM_TEST_SIZE) == 0)) {
+		printf("  memset or memcmp failed\n");
+		goto out;
+	}
+
+	ret = 0;
+out:
+	free(src);
+	free(dst);
+	free(ref);
+	return ret;
+}
+
+static void mem_bench(void)
+{
+	uint8_t *src, *dst;
+	unsigned int i, n = 64;
+	uint64_t t;
+
+	src = malloc(MEM_BENCH_SIZE + 8);
+	dst = malloc(MEM_BENCH_SIZE + 8);
+	if ((src == NULL) || (dst == NULL))
+		goto out;
+	host_fill_random(src, MEM_BENCH_SIZE + 8, 2);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		tf_memcpy(dst, src, MEM_BENCH_SIZE);
+	bench_report("memcpy 1MB, aligned", MEM_BENCH_SIZE * n, n,
+		     host_time_ns() - t);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		tf_memcpy(dst + 1, src + 3, MEM_BENCH_SIZE);
+	bench_report("memcpy 1MB, unaligned", MEM_BENCH_SIZE * n, n,
+		     host_time_ns() - t);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		memcpy(dst, src, MEM_BENCH_SIZE);
+	bench_report("memcpy 1MB, host libc (reference)",
+		     MEM_BENCH_SIZE * n, n, host_time_ns() - t);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		tf_memset(dst, i, MEM_BENCH_SIZE);
+	bench_report("memset 1MB", MEM_BENCH_SIZE * n, n, host_time_ns() - t);
+out:
+	free(src);
+	free(dst);
+}
+
+const host_test_t test_mem = {
+	.name = "mem",
+	.run = mem_run,
+	.bench = mem_bench,
+};
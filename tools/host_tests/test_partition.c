@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gpt.h>
+#include <io_block.h>
+#include <io_storage.h>
+#include <mbr.h>
+#include <partition.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "host_tests.h"
+
+/*
+ * Tests of the GPT parser on a disk image with a primary and a backup GPT,
+ * read through io_block from a file.
+ */
+
+#define DISK_BLOCKS		2048
+#define DISK_SIZE		(DISK_BLOCKS * PARTITION_BLOCK_SIZE)
+#define DISK_PARTS		32
+/* Blocks taken by the 128 entries of the partition entry array */
+#define ENTRY_BLOCKS		((128 * sizeof(gpt_entry_t)) / \
+				 PARTITION_BLOCK_SIZE)
+
+static uint8_t disk[DISK_SIZE];
+static char disk_path[256];
+static io_block_spec_t disk_spec = {
+	.offset = 0,
+	.length = DISK_SIZE,
+};
+
+static void write_gpt_header(uint64_t lba, uint64_t backup_lba,
+			     uint64_t part_lba, uint32_t part_crc)
+{
+	gpt_header_t *header;
+
+	header = (gpt_header_t *)(disk + (lba * PARTITION_BLOCK_SIZE));
+	memset(header, 0, PARTITION_BLOCK_SIZE);
+	memcpy(header->signature, GPT_SIGNATURE, sizeof(header->signature));
+	header->revision = 0x10000;
+	header->size = GPT_HEADER_MIN_SIZE;
+	header->current_lba = lba;
+	header->backup_lba = backup_lba;
+	header->first_lba = 2 + ENTRY_BLOCKS;
+	header->last_lba = DISK_BLOCKS - 2 - ENTRY_BLOCKS;
+	header->part_lba = part_lba;
+	header->list_num = 128;
+	header->part_size = sizeof(gpt_entry_t);
+	header->part_crc = part_crc;
+	/* The CRC of the firmware zlib is used as an independent reference */
+	header->header_crc = crc32(0, (const uint8_t *)header, header->size);
+}
+
+/* Build a disk image with DISK_PARTS partitions called "part<n>" */
+static void build_disk(void)
+{
+	gpt_entry_t *entries;
+	mbr_entry_t *mbr;
+	uint64_t backup_part_lba = DISK_BLOCKS - 1 - ENTRY_BLOCKS;
+	uint32_t part_crc;
+	unsigned int i, j;
+	char name[EFI_NAMELEN];
+
+	memset(disk, 0, sizeof(disk));
+
+	/* Protective MBR */
+	mbr = (mbr_entry_t *)(disk + MBR_PRIMARY_ENTRY_OFFSET);
+	mbr->type = PARTITION_TYPE_GPT;
+	mbr->first_lba = 1;
+	mbr->sector_nums = DISK_BLOCKS - 1;
+	disk[PARTITION_BLOCK_SIZE - 2] = MBR_SIGNATURE_FIRST;
+	disk[PARTITION_BLOCK_SIZE - 1] = MBR_SIGNATURE_SECOND;
+
+	entries = (gpt_entry_t *)(disk + GPT_ENTRY_OFFSET);
+	for (i = 0; i < DISK_PARTS; i++) {
+		host_fill_random(entries[i].type_uuid, GUID_LEN, i + 1);
+		host_fill_random(entries[i].unique_uuid, GUID_LEN, i + 100);
+		entries[i].first_lba = 64 + (i * 16);
+		entries[i].last_lba = entries[i].first_lba + i;
+		snprintf(name, sizeof(name), "part%u", i);
+		for (j = 0; name[j] != '\0'; j++)
+			entries[i].name[j] = name[j];
+	}
+	part_crc = crc32(0, (const uint8_t *)entries,
+			 128 * sizeof(gpt_entry_t));
+
+	memcpy(disk + (backup_part_lba * PARTITION_BLOCK_SIZE), entries,
+	       128 * sizeof(gpt_entry_t));
+	write_gpt_header(1, DISK_BLOCKS - 1, 2, part_crc);
+	write_gpt_header(DISK_BLOCKS - 1, 1, backup_part_lba, part_crc);
+}
+
+/* Load the partition table of the current disk image */
+static int load_disk(void)
+{
+	uintptr_t dev_handle;
+	int ret;
+
+	if ((host_tmp_file(disk, sizeof(disk), disk_path,
+			   sizeof(disk_path)) != 0) ||
+	    (host_block_open(disk_path, PARTITION_BLOCK_SIZE) != 0))
+		return -1;
+
+	ret = host_block_dev_open(&dev_handle);
+	if (ret == 0) {
+		host_set_image_source(HOST_GPT_IMAGE_ID, dev_handle,
+				      (uintptr_t)&disk_spec);
+		ret = load_partition_table(HOST_GPT_IMAGE_ID);
+		io_dev_close(dev_handle);
+	}
+
+	host_block_close();
+	unlink(disk_path);
+
+	return ret;
+}
+
+static int check_entries(void)
+{
+	const partition_entry_list_t *list = get_partition_entry_list();
+	const partition_entry_t *entry;
+	unsigned int i;
+	char name[EFI_NAMELEN];
+
+	CHECK(list->entry_count == DISK_PARTS);
+
+	for (i = 0; i < DISK_PARTS; i++) {
+		snprintf(name, sizeof(name), "part%u", i);
+		entry = get_partition_entry(name);
+		CHECK(entry == &list->list[i]);
+		CHECK(entry->start == (64 + (i * 16)) * PARTITION_BLOCK_SIZE);
+		CHECK(entry->length == (i + 1) * PARTITION_BLOCK_SIZE);
+	}
+	CHECK(get_partition_entry("part") == NULL);
+	CHECK(get_partition_entry("part32") == NULL);
+
+	return 0;
+}
+
+static int partition_run(void)
+{
+	gpt_header_t *header;
+
+	/* gpt_crc32() must agree with the zlib CRC32 */
+	host_fill_random(disk, 1000, 3);
+	CHECK(gpt_crc32(0, disk, 1000) == crc32(0, disk, 1000));
+	CHECK(gpt_crc32(gpt_crc32(0, disk, 300), disk + 300, 700) ==
+	      crc32(0, disk, 1000));
+
+	build_disk();
+	CHECK(load_disk() == 0);
+	CHECK(check_entries() == 0);
+
+	/* A corrupted primary header falls back to the backup GPT */
+	build_disk();
+	disk[GPT_HEADER_OFFSET + 20] ^= 1;
+	CHECK(load_disk() == 0);
+	CHECK(check_entries() == 0);
+
+	/* So does a corrupted primary partition entry array */
+	build_disk();
+	disk[GPT_ENTRY_OFFSET + 200] ^= 1;
+	CHECK(load_disk() == 0);
+	CHECK(check_entries() == 0);
+
+	/* Both GPTs corrupted */
+	build_disk();
+	disk[GPT_HEADER_OFFSET + 20] ^= 1;
+	header = (gpt_header_t *)(disk + DISK_SIZE - PARTITION_BLOCK_SIZE);
+	header->part_crc ^= 1;
+	CHECK(load_disk() != 0);
+
+	return 0;
+}
+
+static void partition_bench(void)
+{
+	uintptr_t dev_handle;
+	unsigned int i, n = 2000;
+	char names[DISK_PARTS][EFI_NAMELEN];
+	uint64_t t;
+
+	for (i = 0; i < DISK_PARTS; i++)
+		snprintf(names[i], EFI_NAMELEN, "part%u", i);
+
+	build_disk();
+	if ((host_tmp_file(disk, sizeof(disk), disk_path,
+			   sizeof(disk_path)) != 0) ||
+	    (host_block_open(disk_path, PARTITION_BLOCK_SIZE) != 0))
+		return;
+
+	if (host_block_dev_open(&dev_handle) != 0)
+		goto out;
+	host_set_image_source(HOST_GPT_IMAGE_ID, dev_handle,
+			      (uintptr_t)&disk_spec);
+
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		load_partition_table(HOST_GPT_IMAGE_ID);
+	bench_report("GPT load, 32 partitions", 0, n, host_time_ns() - t);
+	io_dev_close(dev_handle);
+
+	n = 1000000;
+	t = host_time_ns();
+	for (i = 0; i < n; i++)
+		get_partition_entry(names[i % DISK_PARTS]);
+	bench_report("partition lookup by name", 0, n, host_time_ns() - t);
+out:
+	host_block_close();
+	unlink(disk_path);
+}
+
+const host_test_t test_partition = {
+	.name = "partition",
+	.run = partition_run,
+	.bench = partition_bench,
+};
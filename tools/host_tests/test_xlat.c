@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include <types.h>
+#include <xlat_tables_v2.h>
+
+#include "host_tests.h"
+
+/*
+ * Tests of the translation tables library. The tables are built for the EL3
+ * regime and checked with get_mem_attributes(), they are never used by an
+ * MMU.
+ */
+
+#define XLAT_TEST_MMAP_REGIONS	24
+#define XLAT_TEST_TABLES	16
+#define XLAT_TEST_VA_SIZE	(1ULL << 32)
+
+REGISTER_XLAT_CONTEXT2(test, XLAT_TEST_MMAP_REGIONS, XLAT_TEST_TABLES,
+		       XLAT_TEST_VA_SIZE, XLAT_TEST_VA_SIZE, EL3_REGIME,
+		       "xlat_table");
+
+static xlat_ctx_t test_xlat_ctx_init;
+
+/* Return the context to its state before any region was added */
+static void xlat_reset(void)
+{
+	static int saved;
+
+	if (!saved) {
+		test_xlat_ctx_init = test_xlat_ctx;
+		saved = 1;
+	}
+
+	test_xlat_ctx = test_xlat_ctx_init;
+	memset(test_mmap, 0, sizeof(test_mmap));
+}
+
+static int check_attr(uintptr_t va, mmap_attr_t expected)
+{
+	mmap_attr_t attr;
+
+	CHECK(get_mem_attributes(&test_xlat_ctx, va, &attr) == 0);
+	if (attr != expected) {
+		printf("  VA 0x%lx: attributes 0x%x, expected 0x%x\n",
+		       (unsigned long)va, attr, expected);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int xlat_run(void)
+{
+	mmap_region_t dyn = MAP_REGION_FLAT(0x90000000, 0x3000,
+					    MT_MEMORY | MT_RW | MT_NS);
+	mmap_attr_t attr;
+
+	xlat_reset();
+
+	/* A 2MB block, pages around it and an overlapping region */
+	mmap_add_region_ctx(&test_xlat_ctx,
+		&(mmap_region_t)MAP_REGION_FLAT(0x80000000, 0x200000,
+						MT_RW_DATA));
+	mmap_add_region_ctx(&test_xlat_ctx,
+		&(mmap_region_t)MAP_REGION_FLAT(0x80200000, 0x5000,
+						MT_CODE));
+	mmap_add_region_ctx(&test_xlat_ctx,
+		&(mmap_region_t)MAP_REGION_FLAT(0x80100000, 0x1000,
+						MT_RO_DATA));
+	mmap_add_region_ctx(&test_xlat_ctx,
+		&(mmap_region_t)MAP_REGION_FLAT(0x1c000000, 0x10000,
+						MT_DEVICE | MT_RW | MT_SECURE));
+	mmap_add_region_ctx(&test_xlat_ctx,
+		&(mmap_region_t)MAP_REGION(0xf0000000, 0x40000000, 0x100000,
+					   MT_MEMORY | MT_RW | MT_NS));
+	init_xlat_tables_ctx(&test_xlat_ctx);
+
+	CHECK(check_attr(0x80000000, MT_RW_DATA) == 0);
+	CHECK(check_attr(0x801ff000, MT_RW_DATA) == 0);
+	CHECK(check_attr(0x80100000, MT_RO_DATA) == 0);
+	CHECK(check_attr(0x80204000, MT_CODE) == 0);
+	CHECK(check_attr(0x1c00f000,
+			 MT_DEVICE | MT_RW | MT_EXECUTE_NEVER) == 0);
+	CHECK(check_attr(0x40080000,
+			 MT_MEMORY | MT_RW | MT_NS | MT_EXECUTE_NEVER) == 0);
+	CHECK(get_mem_attributes(&test_xlat_ctx, 0x80205000, &attr) != 0);
+	CHECK(get_mem_attributes(&test_xlat_ctx, 0x0, &attr) != 0);
+
+	/* Dynamic regions */
+	CHECK(mmap_add_dynamic_region_ctx(&test_xlat_ctx, &dyn) == 0);
+	CHECK(check_attr(0x90002000,
+			 MT_MEMORY | MT_RW | MT_NS | MT_EXECUTE_NEVER) == 0);
+	CHECK(mmap_remove_dynamic_region_ctx(&test_xlat_ctx, 0x90000000,
+					     0x3000) == 0);
+	CHECK(get_mem_attributes(&test_xlat_ctx, 0x90002000, &attr) != 0);
+
+	/* Attribute changes are page granular */
+	CHECK(change_mem_attributes(&test_xlat_ctx, 0x80202000, 0x1000,
+				    MT_RO_DATA) == 0);
+	CHECK(check_attr(0x80202000, MT_RO_DATA) == 0);
+	CHECK(check_attr(0x80203000, MT_CODE) == 0);
+	CHECK(change_mem_attributes(&test_xlat_ctx, 0x80202000, 0x1000,
+				    MT_MEMORY | MT_RW | MT_EXECUTE) != 0);
+
+	return 0;
+}
+
+static void xlat_bench(void)
+{
+	unsigned int i, j, n = 2000;
+	uint64_t t;
+
+	/*
+	 * Twenty regions, a typical BL31 memory map: page aligned regions
+	 * and a few large ones.
+	 */
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		xlat_reset();
+		for (j = 0; j < 16; j++) {
+			mmap_add_region_ctx(&test_xlat_ctx,
+				&(mmap_region_t)MAP_REGION_FLAT(
+					0x04000000 + (j * 0x11000),
+					0x3000 + (j * 0x1000),
+					(j & 1) ? MT_RW_DATA : MT_CODE));
+		}
+		for (j = 0; j < 4; j++) {
+			mmap_add_region_ctx(&test_xlat_ctx,
+				&(mmap_region_t)MAP_REGION_FLAT(
+					0x80000000 + (j * 0x10000000),
+					0x08000000,
+					MT_MEMORY | MT_RW | MT_NS));
+		}
+		init_xlat_tables_ctx(&test_xlat_ctx);
+	}
+	bench_report("xlat tables build, 20 regions", 0, n,
+		     host_time_ns() - t);
+
+	n = 200;
+	t = host_time_ns();
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < 16; j++)
+			change_mem_attributes(&test_xlat_ctx,
+					      0x04000000 + (j * 0x11000),
+					      0x1000, MT_RO_DATA);
+	}
+	bench_report("xlat change attributes, one page", 0, n * 16,
+		     host_time_ns() - t);
+}
+
+const host_test_t test_xlat = {
+	.name = "xlat",
+	.run = xlat_run,
+	.bench = xlat_bench,
+};